@@ -79,9 +79,58 @@ namespace ChronusQ {
   enum CONTRACTION_ALGORITHM {
     DIRECT,
     INCORE,
-    DENFIT
+    DENFIT,
+    SEMIDIRECT
   }; ///< 2-e Integral Contraction Algorithm
 
+  enum ERI_STORAGE_TYPE {
+    DENSE_ERI, ///< Full NB^4 tensor (mn|kl)
+    PACKED_ERI, ///< Unique (ij|kl), i>=j, k>=l, ij>=kl
+    SPARSE_ERI  ///< Schwartz screened unique shell quartets
+  }; ///< INCORE ERI storage scheme
+
+
+  /**
+   *  The ERIShellQuartet struct. Locates a surviving shell quartet 
+   *  (s1 s2 | s3 s4) in the SPARSE_ERI storage. Stored in a list
+   *  keyed by the (s1,s2) shell pair.
+   */ 
+  struct ERIShellQuartet {
+
+    size_t s3;     ///< Index of shell 3
+    size_t s4;     ///< Index of shell 4
+    size_t offset; ///< Offset of the (n1 n2 | n3 n4) block in ERI
+
+  }; // struct ERIShellQuartet
+
+
+  /**
+   *  The ERICacheBatch struct. Describes a contiguous batch of shell pairs
+   *  (s12Start <= s12 < s12End) in the SEMIDIRECT scratch file. The batch
+   *  is the unit of disk I/O.
+   */ 
+  struct ERICacheBatch {
+
+    size_t s12Start; ///< First (s1,s2) shell pair in the batch
+    size_t s12End;   ///< One past the last (s1,s2) shell pair in the batch
+    size_t offset;   ///< Offset (in doubles) of the batch in the file
+    size_t size;     ///< Number of integrals in the batch
+
+  }; // struct ERICacheBatch
+
+
+  /**
+   *  The ERIShellPairTask struct. A unit of work for the DIRECT ERI
+   *  contraction: all (s1 s2 | s3 s4) with s3 <= s1 for a fixed (s1,s2).
+   */ 
+  struct ERIShellPairTask {
+
+    size_t s1;   ///< Index of shell 1
+    size_t s2;   ///< Index of shell 2
+    double cost; ///< Estimated cost of the task (see computeDirectTasks)
+
+  }; // struct ERIShellPairTask
+
   enum ORTHO_TYPE {
     LOWDIN,
     CHOLESKY
@@ -283,9 +332,18 @@ namespace ChronusQ {
     // Control Variables
     CORE_HAMILTONIAN_TYPE coreType;
     CONTRACTION_ALGORITHM cAlg;      ///< Algorithm for 2-body contraction
+    ERI_STORAGE_TYPE      eriStore;  ///< Storage scheme for INCORE ERIs
     ORTHO_TYPE            orthoType; ///< Orthogonalization scheme
 
     double threshSchwartz; ///< Schwartz screening threshold
+    double threshDenScreen; ///< Density weighted screening threshold for
+                            ///< DIRECT contractions (<= 0 -> threshSchwartz)
+
+    size_t nQuartetScreened; ///< Screened shell quartets (last DIRECT call)
+    size_t nQuartetTotal;    ///< Examined shell quartets (last DIRECT call)
+
+    std::string scrFileName;    ///< Scratch file for the SEMIDIRECT ERIs
+    size_t semiDirectBuffer;    ///< Size (in doubles) of SEMIDIRECT buffers
 
 
     // Hard storage of integrals
@@ -323,6 +381,25 @@ namespace ChronusQ {
     // 2-e Storage
       
     oper_t ERI;    ///< Electron-Electron repulsion integrals (4 index) 
+                   ///< (see eriStore for the layout)
+
+    /// SPARSE_ERI index: s1*(s1+1)/2 + s2 -> surviving (s3,s4) blocks
+    std::vector<std::vector<ERIShellQuartet>> sparseERIIndex;
+
+    /// SEMIDIRECT I/O batches (see computeERISemiDirect)
+    std::vector<ERICacheBatch> semiDirectBatches;
+    bool semiDirectCached; ///< Whether the SEMIDIRECT scratch file is populated
+
+    /// DIRECT shell pair tasks sorted by decreasing cost
+    std::vector<ERIShellPairTask> directTasks;
+    double directTasksThresh; ///< threshSchwartz used to build directTasks
+
+    // Density fitting
+      
+    std::shared_ptr<BasisSet> auxBasisSet; ///< Auxiliary basis for DENFIT
+
+    oper_t ERI3J;    ///< Fitted 3-index ERIs (mn|P) L**-T (see computeERI3Index)
+    oper_t DFMetric; ///< Cholesky factor of the 2-index metric (P|Q) = L L**T
 
     // Constructors
     
@@ -337,10 +414,15 @@ namespace ChronusQ {
      *  \param [in] basis      The GTO basis for integral evaluation
      */ 
     AOIntegrals(CQMemManager &memManager, Molecule &mol, BasisSet &basis) :
-      threshSchwartz(1e-12), cAlg(DIRECT), orthoType(LOWDIN), 
+      threshSchwartz(1e-12), threshDenScreen(0.), nQuartetScreened(0), 
+      nQuartetTotal(0), cAlg(DIRECT), eriStore(DENSE_ERI), 
+      orthoType(LOWDIN), scrFileName("ChronusQ.scr"), 
+      semiDirectBuffer(1048576), 
       memManager_(memManager), basisSet_(basis), molecule_(mol), 
       schwartz(nullptr), ortho1(nullptr), ortho2(nullptr), overlap(nullptr), 
-      kinetic(nullptr), potential(nullptr), ERI(nullptr), coreType(NON_RELATIVISTIC) {
+      kinetic(nullptr), potential(nullptr), ERI(nullptr),
+      semiDirectCached(false), directTasksThresh(0.), ERI3J(nullptr),
+      DFMetric(nullptr), coreType(NON_RELATIVISTIC) {
 
       nTT_  = basis.nBasis * ( basis.nBasis + 1 ) / 2;
       nSQ_  = basis.nBasis * basis.nBasis;
@@ -405,8 +487,13 @@ namespace ChronusQ {
 
     void computeAOOneE(bool); // Evaluate the 1-e ints in the CGTO basis
     void computeERI();    // Evaluate and store the ERIs in the CGTO basis
+    void computeERISparse(); // Evaluate and store the screened ERIs
+    size_t computeSparseERIIndex(); // Determine the surviving quartets
+    void computeERISemiDirect(); // Evaluate and cache the ERIs on disk
+    void computeDirectTasks(); // Cost estimates for the DIRECT work queue
     void computeOrtho();  // Evaluate orthonormalization transformations
     void computeSchwartz(); // Evaluate schwartz bounds over CGTOS
+    void computeERI3Index(); // Evaluate and store the DF 3-index ERIs
 
     // CH == Core Hamiltonian
     void computeCoreHam(CORE_HAMILTONIAN_TYPE); // Compute the CH
@@ -439,8 +526,12 @@ namespace ChronusQ {
                 return ret;
               }) );
 
+      CQMemTag memTag(memManager_,"ERI");
+
       if( cAlg == INCORE ) twoBodyContractIncore(contList);
       else if( cAlg == DIRECT ) twoBodyContractDirect(contList);
+      else if( cAlg == DENFIT ) twoBodyContractDenFit(contList);
+      else if( cAlg == SEMIDIRECT ) twoBodyContractSemiDirect(contList);
     };
     
 
@@ -457,6 +548,34 @@ namespace ChronusQ {
     template <typename T, typename G>
     void KContractIncore(TwoBodyContraction<T,G> &);
 
+    /**
+     *  \brief Index of (ij|kl) in the PACKED_ERI storage.
+     *
+     *  Pairs are packed as IJ = i*(i+1)/2 + j (i >= j) and quartets as
+     *  IJKL = IJ*(IJ+1)/2 + KL (IJ >= KL).
+     */ 
+    static inline size_t packedERIIndex(size_t i, size_t j, size_t k, 
+      size_t l) {
+
+      size_t IJ = (i >= j) ? i*(i+1)/2 + j : j*(j+1)/2 + i;
+      size_t KL = (k >= l) ? k*(k+1)/2 + l : l*(l+1)/2 + k;
+
+      return (IJ >= KL) ? IJ*(IJ+1)/2 + KL : KL*(KL+1)/2 + IJ;
+
+    }; // packedERIIndex
+
+    template <typename U>
+    void JContractPacked(U *X, U *AX);
+
+    template <typename U>
+    void KContractPacked(U *X, U *AX);
+
+    template <typename U>
+    void JContractSparse(U *X, U *AX);
+
+    template <typename U>
+    void KContractSparse(U *X, U *AX);
+
 
 
     // DIRECT contraction routines
@@ -475,6 +594,33 @@ namespace ChronusQ {
     void KContractDirect(TwoBodyContraction<T,G> &);
 
 
+
+    // SEMIDIRECT contraction routines
+    // Perform the two body contraction by replaying the ERIs cached
+    // on disk by computeERISemiDirect
+    // see include/aointegrals/contract/semidirect.hpp for docs.
+    template <typename T, typename G>
+    void twoBodyContractSemiDirect(std::vector<TwoBodyContraction<T,G>>&);
+
+
+
+    // DENFIT contraction routines
+    // Perform the two body contraction using the density fitted
+    // (rank-3) ERI tensor
+    // see include/aointegrals/contract/denfit.hpp for docs.
+    template <typename T, typename G>
+    void twoBodyContractDenFit(std::vector<TwoBodyContraction<T,G>>&);
+
+    template <typename T, typename G>
+    void JContractDenFit(TwoBodyContraction<T,G> &);
+
+    template <typename T, typename G>
+    void KContractDenFit(TwoBodyContraction<T,G> &);
+
+    void JContractDenFitReal(size_t, double*, double*);
+    void KContractDenFitReal(size_t, double*, double*);
+
+
     // Transformations to and from the orthonormal basis
     // see include/aointegrals/ortho.hpp for docs
       
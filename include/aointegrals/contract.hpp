@@ -29,5 +29,7 @@
 
 #include <aointegrals/contract/incore.hpp>
 #include <aointegrals/contract/direct.hpp>
+#include <aointegrals/contract/denfit.hpp>
+#include <aointegrals/contract/semidirect.hpp>
 
 #endif
@@ -0,0 +1,182 @@
+/* 
+ *  This file is part of the Chronus Quantum (ChronusQ) software package
+ *  
+ *  Copyright (C) 2014-2017 Li Research Group (University of Washington)
+ *  
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *  
+ *  Contact the Developers:
+ *    E-Mail: xsli@uw.edu
+ *  
+ */
+#ifndef __INCLUDED_AOINTEGRALS_CONTRACT_DENFIT_HPP__
+#define __INCLUDED_AOINTEGRALS_CONTRACT_DENFIT_HPP__
+
+
+#include <aointegrals.hpp>
+#include <util/threads.hpp>
+#include <cqlinalg/blas3.hpp>
+#include <cerr.hpp>
+
+namespace ChronusQ {
+
+  /**
+   *  \brief Store the (real, imaginary) pair of a real
+   *  DENFIT contraction into the persistant result storage.
+   *  Discards the imaginary part for real storage.
+   */
+  inline void DenFitSetResult(double &A, double re, double im) { A = re; }
+  inline void DenFitSetResult(dcomplex &A, double re, double im) { 
+    A = dcomplex(re,im); 
+  }
+
+
+  /**
+   *  \brief Perform various tensor contractions of the density
+   *  fitted ERI tensor (see AOIntegrals::computeERI3Index). Wraps 
+   *  other helper functions and provides loop structure
+   *
+   *  Currently supports
+   *    - Coulomb-type (34,12) contractions
+   *    - Exchange-type (23,12) contractions
+   *
+   *  Works with both real and complex matricies
+   *
+   *  \param [in/out] list Contains information pertinent to the 
+   *    matricies to be contracted with. See TwoBodyContraction
+   *    for details
+   */ 
+  template <typename T, typename G>
+  void AOIntegrals::twoBodyContractDenFit(
+    std::vector<TwoBodyContraction<T,G>> &list) {
+
+    if( ERI3J == nullptr ) 
+      CErr("DF ERIs must be computed prior to a DENFIT contraction");
+
+    auto topDenFit = std::chrono::high_resolution_clock::now();
+
+    // Loop over matricies to contract with
+    for(auto &C : list) {
+
+      // Coulomb-type (34,12) ERI contraction
+      // AX(mn) = (mn | kl) X(kl)
+      if( C.contType == COULOMB ) JContractDenFit(C);
+
+      // Exchange-type (23,12) ERI contraction
+      // AX(mn) = (mk |ln) X(kl)
+      else if( C.contType == EXCHANGE ) KContractDenFit(C);
+
+    } // loop over matricies
+
+    auto botDenFit = std::chrono::high_resolution_clock::now();
+    
+    std::chrono::duration<double> durDenFit = botDenFit - topDenFit;
+#ifdef _REPORT_INTEGRAL_TIMINGS
+    std::cerr << "DENFIT Contraction took " << durDenFit.count() << " s\n\n";
+#endif
+
+  }; // AOIntegrals::twoBodyContractDenFit
+
+
+
+  /**
+   *  \brief Perform a Coulomb-type (34,12) ERI contraction with
+   *  a one-body operator using the density fitted ERIs.
+   *
+   *  As the fitted ERIs are real, complex operators are split into
+   *  their real and imaginary parts which are contracted simultaneously.
+   *  Only the real part of an hermetian operator contributes.
+   */   
+  template <typename T, typename G>
+  void AOIntegrals::JContractDenFit(TwoBodyContraction<T,G> &C) {
+
+    if( not C.HER ) assert( (std::is_same<T,G>::value) );
+
+    size_t nCol = (std::is_same<T,double>::value or C.HER) ? 1 : 2;
+
+    double *X, *AX;
+
+    if( std::is_same<T,double>::value )
+      X = reinterpret_cast<double*>(C.X);
+    else {
+      X = memManager_.malloc<double>(nCol*nSQ_);
+      for(auto i = 0ul; i < nSQ_; i++) {
+        X[i] = std::real(C.X[i]);
+        if( nCol == 2 ) X[i + nSQ_] = std::imag(C.X[i]);
+      }
+    }
+
+    if( std::is_same<G,double>::value )
+      AX = reinterpret_cast<double*>(C.AX);
+    else
+      AX = memManager_.malloc<double>(nCol*nSQ_);
+
+    JContractDenFitReal(nCol,X,AX);
+
+    // Cleanup temporaries
+    if( not std::is_same<T,double>::value ) memManager_.free(X);
+    if( not std::is_same<G,double>::value ) {
+      // Copy over result into persistant storage
+      for(auto i = 0ul; i < nSQ_; i++)
+        DenFitSetResult(C.AX[i],AX[i],(nCol == 2) ? AX[i + nSQ_] : 0.);
+      memManager_.free(AX);
+    }
+
+  }; // AOIntegrals::JContractDenFit
+
+
+
+  /**
+   *  \brief Perform an Exchange-type (23,12) ERI contraction with
+   *  a one-body operator using the density fitted ERIs.
+   *
+   *  As the fitted ERIs are real, complex operators are split into
+   *  their real and imaginary parts which are contracted simultaneously.
+   */   
+  template <typename T, typename G>
+  void AOIntegrals::KContractDenFit(TwoBodyContraction<T,G> &C) {
+
+    assert( (std::is_same<T,G>::value) );
+
+    size_t nCol = std::is_same<T,double>::value ? 1 : 2;
+
+    double *X, *AX;
+    if( std::is_same<T,double>::value ) {
+      X  = reinterpret_cast<double*>(C.X);
+      AX = reinterpret_cast<double*>(C.AX);
+    } else {
+      X  = memManager_.malloc<double>(nCol*nSQ_);
+      AX = memManager_.malloc<double>(nCol*nSQ_);
+      for(auto i = 0ul; i < nSQ_; i++) {
+        X[i]         = std::real(C.X[i]);
+        X[i + nSQ_]  = std::imag(C.X[i]);
+      }
+    }
+
+    KContractDenFitReal(nCol,X,AX);
+
+    // Cleanup temporaries
+    if( not std::is_same<T,double>::value ) {
+      // Copy over result into persistant storage
+      for(auto i = 0ul; i < nSQ_; i++)
+        DenFitSetResult(C.AX[i],AX[i],AX[i + nSQ_]);
+      memManager_.free(X,AX);
+    }
+
+  }; // AOIntegrals::KContractDenFit
+
+}; // namespace ChronusQ
+
+#endif
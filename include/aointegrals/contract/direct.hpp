@@ -30,6 +30,7 @@
 #include <cqlinalg/blas1.hpp>
 #include <cqlinalg/blasext.hpp>
 #include <cqlinalg/blasutil.hpp>
+#include <aointegrals/contract/directkernels.hpp>
 
 #include <util/threads.hpp>
 
@@ -52,24 +53,8 @@
   #warning "Batch Direct ERI contraction is broken for complex"
 #endif
 
-#define GetRealPtr(X,I,J,N) reinterpret_cast<double*>(X + I + J*N)
-
 namespace ChronusQ {
 
-  /**
-   *  \brief Handle the fact that std::conj actually returns 
-   *  std::complex
-   */
-  template <typename T>
-  inline T SmartConj(const T&);
- 
-  template <>
-  inline double SmartConj(const double &x) { return x; }
-  template <>
-  inline dcomplex SmartConj(const dcomplex &x) { return std::conj(x); }
-
-
-
   /**
    *  \brief Perform various tensor contractions of the ERI tensor
    *  directly. Wraps other helper functions and provides
@@ -153,6 +138,14 @@ namespace ChronusQ {
     if(schwartz == nullptr) computeSchwartz();
 #endif
 
+    // Screening threshold for the density weighted Schwartz bound
+    const double threshScreen = 
+      (threshDenScreen > 0.) ? threshDenScreen : threshSchwartz;
+
+    // Build the (cost sorted) shell pair work queue if we haven't already
+    if(directTasks.empty() or directTasksThresh != threshSchwartz)
+      computeDirectTasks();
+
 
 
 
@@ -175,6 +168,7 @@ namespace ChronusQ {
           return sh1.size() < sh2.size();
         })->size();
 
+#ifdef _BATCH_DIRECT
     size_t lenIntBuffer = 
       maxShellSize * maxShellSize * nSQ_; 
 
@@ -186,27 +180,56 @@ namespace ChronusQ {
       memManager_.malloc<double>(nBuffer*lenIntBuffer*nthreads);
    
     double *intBuffer2 = intBuffer + nthreads*lenIntBuffer;
+#endif
 
 
-    // Allocate thread local storage to store integral contractions
-    // XXX: Don't allocate anything if serial
-    std::vector<std::vector<G*>> AXthreads;
-    G *AXRaw = nullptr;
-    if(nthreads != 1) {
-      AXRaw = memManager_.malloc<G>(nthreads*NMat*NB*NB);    
-      memset(AXRaw,0,nthreads*NMat*NB*NB*sizeof(G));
-    }
+#ifdef _FULL_DIRECT
+    // Allocate thread local shell strip storage to accumulate the integral
+    // contractions. Each thread holds, for every contraction, the row (R)
+    // and column (C) strips of shells 1, 2 and 3
+    //
+    //   R_s(i,nu) = AX(bf_s + i, nu) : n_s x NB (LD = n_s)
+    //   C_s(mu,j) = AX(mu, bf_s + j) : NB x n_s (LD = NB)
+    //
+    // which are flushed into list[iMat].AX once the shell (s1,s2) pair
+    // (R/C 1 and 2) or shell 3 (R/C 3) is done. This storage scales as 
+    // nthreads * NMat * maxShellSize * NB rather than nthreads * NMat * NB^2.
+    // The strips of hermetian Coulomb-type contractions are stored as real
+    const size_t lenStrip = maxShellSize * NB;
+
+    G *stripRaw = memManager_.malloc<G>(nthreads*NMat*6*lenStrip);
+    std::fill_n(stripRaw,nthreads*NMat*6*lenStrip,G(0.));
+
+    // Column striped locks for the updates of list[iMat].AX: all writes
+    // to the columns of shell s are guarded by colLocks[s]
+    std::vector<std::mutex> colLocks(NS);
+
+
+    // Hermetian Coulomb-type contractions only involve the real part of X
+    // (and only produce a real AX). Cache Re(X) for complex operators such 
+    // that these contractions are carried out in real arithmetic
+    const bool realX = std::is_same<T,double>::value;
+
+    std::vector<double*> XRe(NMat,nullptr);
+    for(auto iMat = 0; iMat < NMat; iMat++)
+      if( list[iMat].HER and list[iMat].contType == COULOMB ) {
+
+        if( realX ) XRe[iMat] = reinterpret_cast<double*>(list[iMat].X);
+        else {
+          XRe[iMat] = memManager_.malloc<double>(NB*NB);
+          for(auto k = 0; k < NB*NB; k++) 
+            XRe[iMat][k] = std::real(list[iMat].X[k]);
+        }
 
-    for(auto ithread = 0, iMat = 0; ithread < nthreads; ithread++) {
-      AXthreads.emplace_back();
-    for(auto jMat = 0; jMat < NMat; jMat++, iMat++) {
-      if(nthreads == 1) {
-        AXthreads.back().push_back(list[jMat].AX);
-      } else {
-        AXthreads.back().push_back(AXRaw + iMat*NB*NB);
       }
-    }
-    }
+
+
+    // The strips are accumulated directly into list[iMat].AX. Non-hermetian
+    // contractions are scaled by 0.5 after the contraction, prescale the 
+    // incoming AX to compensate
+    for(auto iMat = 0; iMat < NMat; iMat++)
+      if( not list[iMat].HER ) Scale(NB*NB,G(2.),list[iMat].AX,1);
+#endif
 
 
 #ifdef _SHZ_SCREEN
@@ -238,7 +261,7 @@ namespace ChronusQ {
     engines[0].set_precision(
       std::min(
         std::numeric_limits<double>::epsilon(),
-        threshSchwartz / maxShBlk
+        threshScreen / maxShBlk
       ) / NP4);
 #else
     // Set precision
@@ -256,7 +279,7 @@ namespace ChronusQ {
 #endif
 
     // Keeping track of number of integrals skipped
-    std::vector<size_t> nSkip(nthreads,0);
+    std::vector<size_t> nSkip(nthreads,0), nVisit(nthreads,0);
 
 
     auto topDirect = std::chrono::high_resolution_clock::now();
@@ -270,25 +293,36 @@ namespace ChronusQ {
     auto &engine = engines[thread_id];
     const auto& buf_vec = engine.results();
     
-    auto &AX_loc = AXthreads[thread_id];
+#ifdef _FULL_DIRECT
+    // Group the contractions by kind such that each kind is handled by a
+    // single (branch free) kernel for all of its operators
+    DirectContractionGroup<double,double> JHer;
+    DirectContractionGroup<T,G>           KHer, JNonHer, KNonHer;
+
+    DirectGroupContractions(list,XRe,stripRaw + thread_id*NMat*6*lenStrip,
+      lenStrip,JHer,KHer,JNonHer,KNonHer);
+#endif
 
 
+#ifdef _BATCH_DIRECT
     double * intBuffer_loc  = intBuffer  + thread_id*lenIntBuffer;
     double * intBuffer2_loc = intBuffer2 + thread_id*lenIntBuffer;
+#endif
 
 
-    size_t n1,n2;
+    // Always Loop over s2 <= s1. The (s1,s2) pairs are pulled 
+    // dynamically from the work queue in order of decreasing cost
+    #pragma omp for schedule(dynamic,1)
+    for(size_t iTask = 0; iTask < directTasks.size(); iTask++) {
 
-    // Always Loop over s2 <= s1
-    for(size_t s1(0ul), bf1_s(0ul), s12(0ul); s1 < NS; bf1_s+=n1, s1++) { 
-      n1 = basisSet_.shells[s1].size(); // Size of Shell 1
+      const size_t s1 = directTasks[iTask].s1;
+      const size_t s2 = directTasks[iTask].s2;
 
-    for(size_t s2(0ul), bf2_s(0ul); s2 <= s1; bf2_s+=n2, s2++, s12++) {
-      n2 = basisSet_.shells[s2].size(); // Size of Shell 2
+      const size_t n1 = basisSet_.shells[s1].size(); // Size of Shell 1
+      const size_t n2 = basisSet_.shells[s2].size(); // Size of Shell 2
 
-
-      // Round-Robbin work distribution
-      if( s12 % nthreads != thread_id ) continue;
+      const size_t bf1_s = basisSet_.mapSh2Bf[s1];
+      const size_t bf2_s = basisSet_.mapSh2Bf[s2];
 
 
       // Cache variables for shells 1 and 2
@@ -296,6 +330,9 @@ namespace ChronusQ {
 #ifdef _FULL_DIRECT
       // Deneneracy factor for s1,s2 pair
       double s12_deg = (s1 == s2) ? 1.0 : 2.0;
+
+      // Whether any quartet contributed to the shell 1 and 2 strips
+      bool s12Touched = false;
 #endif
 
 #ifdef _SHZ_SCREEN
@@ -383,6 +420,11 @@ namespace ChronusQ {
         size_t s4_max =  s3;
 #endif
 
+#ifdef _FULL_DIRECT
+        // Range of shell 4 which contributes to the shell 3 strips
+        size_t s4Lo = NS, s4Hi = 0;
+#endif
+
 
 // If we're doing batch direct, also increment the current buffer index
 #ifdef _BATCH_DIRECT
@@ -394,6 +436,8 @@ namespace ChronusQ {
       {
         n4 = basisSet_.shells[s4].size(); // Size of Shell 4
 
+        nVisit[thread_id]++;
+
 #ifdef _SHZ_SCREEN
         // Compute Shell norm max
         double shMax = 
@@ -420,7 +464,7 @@ namespace ChronusQ {
         shMax = std::max(shMax,shMax123);
 
         if((shMax * shz12 * schwartz[s3 + s4*NS]) < 
-           threshSchwartz) { nSkip[thread_id]++; continue; }
+           threshScreen) { nSkip[thread_id]++; continue; }
 #endif
       
 
@@ -458,166 +502,36 @@ namespace ChronusQ {
 
 #elif defined(_FULL_DIRECT)
 
-// Flag to turn contraction on and off
-#if 1
-        // Scale the buffer by the degeneracy factor and store
-        // in infBuffer
-        std::transform(buff,buff + n1*n2*n3*n4,intBuffer_loc,
-          std::bind1st(std::multiplies<double>(),0.5*s1234_deg));
-
-        size_t b1,b2,b3,b4;
-        double *Xp1, *Xp2;
-        double X1,X2;
-        T      T1,T2,T3,T4;
-        T      *Tp1,*Tp2;
-
-        for(auto iMat = 0; iMat < NMat; iMat++) {
-          
-          // Hermetian contraction
-          if( list[iMat].HER ) { 
-
-            if( list[iMat].contType == COULOMB )
-            for(auto i = 0ul, bf1 = bf1_s, ijkl(0ul); i < n1; i++, bf1++)      
-            for(auto j = 0ul, bf2 = bf2_s; j < n2; j++, bf2++) { 
-              // Cache i,j variables
-              b1 = bf1 + NB*bf2; 
-              X1 = *reinterpret_cast<double*>(list[iMat].X  + b1);
-              Xp1 = reinterpret_cast<double*>(AX_loc[iMat] + b1);
-            for(auto k = 0ul, bf3 = bf3_s; k < n3; k++, bf3++) 
-            for(auto l = 0ul, bf4 = bf4_s; l < n4; l++, bf4++, ijkl++) { 
-
-              // J(1,2) += I * X(4,3)
-              *Xp1 += *GetRealPtr(list[iMat].X,bf4,bf3,NB) * intBuffer_loc[ijkl];
-
-              // J(4,3) += I * X(1,2)
-              *GetRealPtr(AX_loc[iMat],bf4,bf3,NB) +=  X1 * intBuffer_loc[ijkl];
-
-              // J(2,1) and J(3,4) are handled on symmetrization after
-              // contraction
-                
-            } // kl loop
-            } // ij loop
-
-            else if( list[iMat].contType == EXCHANGE )
-            for(auto i = 0ul, bf1 = bf1_s, ijkl(0ul); i < n1; i++, bf1++)      
-            for(auto j = 0ul, bf2 = bf2_s; j < n2; j++, bf2++)       
-            for(auto k = 0ul, bf3 = bf3_s; k < n3; k++, bf3++) {
-
-              // Cache i,j,k variables
-              b1 = bf1 + bf3*NB;
-              b2 = bf2 + bf3*NB;
-
-              T1 = 0.5 * SmartConj(list[iMat].X[b1]);
-              T2 = 0.5 * SmartConj(list[iMat].X[b2]);
-
-            for(auto l = 0ul, bf4 = bf4_s; l < n4; l++, bf4++, ijkl++) { 
-
-              // Indicies are swapped here to loop over contiguous memory
-                
-              // K(1,3) += 0.5 * I * X(2,4) = 0.5 * I * CONJ(X(4,2)) (**HER**)
-              AX_loc[iMat][b1]           += 0.5 * SmartConj(list[iMat].X[bf4+NB*bf2]) * intBuffer_loc[ijkl];
-
-              // K(4,2) += 0.5 * I * X(3,1) = 0.5 * I * CONJ(X(1,3)) (**HER**)
-              AX_loc[iMat][bf4 + bf2*NB] += T1 * intBuffer_loc[ijkl];
-
-              // K(4,1) += 0.5 * I * X(3,2) = 0.5 * I * CONJ(X(2,3)) (**HER**)
-              AX_loc[iMat][bf4 + bf1*NB] += T2 * intBuffer_loc[ijkl];
-
-              // K(2,3) += 0.5 * I * X(1,4) = 0.5 * I * CONJ(X(4,1)) (**HER**)
-              AX_loc[iMat][b2]           += 0.5 * SmartConj(list[iMat].X[bf4+NB*bf1]) * intBuffer_loc[ijkl];
-
-            } // l loop
-            } // ijk
+        // Track the range of shell 4 (and the shell pair) touched
+        s4Lo = std::min(s4Lo,s4); s4Hi = std::max(s4Hi,s4);
+        s12Touched = true;
 
-          // Nonhermetian contraction
-          } else {
+        // Contract the quartet with all of the operators at once
+        const DirectShellQuartet Q = { n1, n2, n3, n4, 
+          bf1_s, bf2_s, bf3_s, bf4_s, NB, 0.5*s1234_deg, buff };
 
-            if( list[iMat].contType == COULOMB )
-            for(auto i = 0ul, bf1 = bf1_s, ijkl(0ul); i < n1; i++, bf1++)      
-            for(auto j = 0ul, bf2 = bf2_s; j < n2; j++, bf2++) { 
-              // Cache i,j variables
-              b1 = bf1 + NB*bf2; 
-              T1 = *(list[iMat].X  + b1);
-              Tp1 = (AX_loc[iMat] + b1);
-
-              b2 = bf2 + NB*bf1; 
-              T2 = *(list[iMat].X  + b2);
-              Tp2 = (AX_loc[iMat] + b2);
-            for(auto k = 0ul, bf3 = bf3_s; k < n3; k++, bf3++) 
-            for(auto l = 0ul, bf4 = bf4_s; l < n4; l++, bf4++, ijkl++) { 
-
-              // J(1,2) += I * X(4,3)
-              *Tp1 += 0.5*( list[iMat].X[bf4 + bf3*NB] + list[iMat].X[bf3 + bf4*NB]) * intBuffer_loc[ijkl];
-
-              // J(3,4) += I * X(2,1)
-              AX_loc[iMat][bf3 + bf4*NB] +=  0.5*(T2+T1) * intBuffer_loc[ijkl];
-
-              // J(2,1) += I * X(3,4)
-              *Tp2 += 0.5*( list[iMat].X[bf4 + bf3*NB] + list[iMat].X[bf3 + bf4*NB]) * intBuffer_loc[ijkl];
-
-              // J(4,3) += I * X(1,2)
-              AX_loc[iMat][bf4 + bf3*NB] +=  0.5*(T2+T1) * intBuffer_loc[ijkl];
-
-            } // kl loop
-            } // ij loop
-
-            else if( list[iMat].contType == EXCHANGE )
-            for(auto i = 0ul, bf1 = bf1_s, ijkl(0ul); i < n1; i++, bf1++)      
-            for(auto j = 0ul, bf2 = bf2_s; j < n2; j++, bf2++)       
-            for(auto k = 0ul, bf3 = bf3_s; k < n3; k++, bf3++) {
-
-              // Cache i,j,k variables
-              b1 = bf1 + bf3*NB;
-              b2 = bf2 + bf3*NB;
-
-              T1 = 0.5 * list[iMat].X[b1];
-              T2 = 0.5 * list[iMat].X[b2];
-
-              b3 = bf3 + bf1*NB;
-              b4 = bf3 + bf2*NB;
-
-              T3 = 0.5 * list[iMat].X[b3];
-              T4 = 0.5 * list[iMat].X[b4];
-            for(auto l = 0ul, bf4 = bf4_s; l < n4; l++, bf4++, ijkl++) { 
-
-              // K(3,1) += 0.5 * I * X(4,2)
-              AX_loc[iMat][b3]           += 0.5 * list[iMat].X[bf4+NB*bf2] * intBuffer_loc[ijkl];
-
-              // K(4,2) += 0.5 * I * X(3,1)
-              AX_loc[iMat][bf4 + bf2*NB] += T3 * intBuffer_loc[ijkl];
- 
-              // K(4,1) += 0.5 * I * X(3,2)
-              AX_loc[iMat][bf4 + bf1*NB] += T4 * intBuffer_loc[ijkl];
-
-              // K(3,2) += 0.5 * I * X(4,1)
-              AX_loc[iMat][b4]           += 0.5 * list[iMat].X[bf4+NB*bf1] * intBuffer_loc[ijkl];
-
-              // K(1,3) += 0.5 * I * X(2,4)
-              AX_loc[iMat][b1]           += 0.5 * list[iMat].X[bf2+NB*bf4] * intBuffer_loc[ijkl];
-
-              // K(2,4) += 0.5 * I * X(1,3)
-              AX_loc[iMat][bf2 + bf4*NB] += T1 * intBuffer_loc[ijkl];
- 
-              // K(1,4) += 0.5 * I * X(2,3)
-              AX_loc[iMat][bf1 + bf4*NB] += T2 * intBuffer_loc[ijkl];
-
-              // K(2,3) += 0.5 * I * X(1,4)
-              AX_loc[iMat][b2]           += 0.5 * list[iMat].X[bf1+NB*bf4] * intBuffer_loc[ijkl];
-
-            } // l loop
-            } // ijk
-
-          } // Symmetry check
-
-        } // iMat loop
+        DirectContractQuartet(Q,JHer,KHer,JNonHer,KNonHer);
 
 #endif
 
+      } // loop s4
+
+#ifdef _FULL_DIRECT
+        // Flush the shell 3 strips (Coulomb-type only)
+        if( s4Lo <= s4Hi ) 
+          DirectFlushShell3(list,JHer,JNonHer,basisSet_,colLocks,s3,s4Lo,
+            s4Hi);
 #endif
 
-      } // loop s4
       } // loop s3
 
+#ifdef _FULL_DIRECT
+      // Flush the shell 1 and 2 strips
+      if( s12Touched ) 
+        DirectFlushShellPair(list,JHer,KHer,JNonHer,KNonHer,basisSet_,
+          colLocks,s1,s2);
+#endif
+
 #ifdef _SUB_TIMINGS
       auto botInner = std::chrono::high_resolution_clock::now();
 
@@ -723,14 +637,16 @@ namespace ChronusQ {
 
 #endif
 
-    }; // s2
-    }; // s1
+    }; // s12 tasks
 
 
     }; // OpenMP context
 
     auto botDirect = std::chrono::high_resolution_clock::now();
 
+    nQuartetScreened = std::accumulate(nSkip.begin(),nSkip.end(),0ul);
+    nQuartetTotal    = std::accumulate(nVisit.begin(),nVisit.end(),0ul);
+
 #ifdef _REPORT_INTEGRAL_TIMINGS
     size_t nIntSkip = std::accumulate(nSkip.begin(),nSkip.end(),0);
     std::cerr << "Screened " << nIntSkip << std::endl;
@@ -756,38 +672,7 @@ namespace ChronusQ {
 
 #ifdef _FULL_DIRECT
 
-    for( auto iMat = 0; iMat < NMat;  iMat++ ) 
-    for( auto iTh  = 0; iTh < nthreads; iTh++) {
-  
-    //prettyPrintSmart(std::cerr,"AX " + std::to_string(iMat) + " " + std::to_string(iTh),
-    //  AXthreads[iTh][iMat],NB,NB,NB);
-
-      if( list[iMat].HER ) {
-
-        MatAdd('N','C',NB,NB,G(0.5),AXthreads[iTh][iMat],NB,G(0.5),
-          AXthreads[iTh][iMat],NB,reinterpret_cast<G*>(intBuffer),NB);
-
-        if( nthreads != 1 )
-          MatAdd('N','N',NB,NB,G(1.),reinterpret_cast<G*>(intBuffer),NB,
-            G(1.), list[iMat].AX,NB,list[iMat].AX,NB);
-        else
-          SetMat('N',NB,NB,G(1.),reinterpret_cast<G*>(intBuffer),NB,
-            list[iMat].AX,NB);
-
-      } else {
-
-        if( nthreads != 1 )
-          MatAdd('N','N',NB,NB,G(0.5),AXthreads[iTh][iMat],NB,
-            G(1.), list[iMat].AX,NB,list[iMat].AX,NB);
-        else 
-          Scale(NB*NB,G(0.5),list[iMat].AX,1);
-
-
-      //std::transform(AXthreads[iTh][iMat], AXthreads[iTh][iMat] + NB*NB, 
-      //  list[iMat].AX, []( G x ) -> G { return x / 4.; } );
-      }
-
-    };
+    DirectSymmetrize(list,NB);
     
 #else
 
@@ -810,11 +695,17 @@ namespace ChronusQ {
 #endif
 
     // Free scratch space
+#ifdef _BATCH_DIRECT
     memManager_.free(intBuffer);
+#endif
 #ifdef _SHZ_SCREEN
     memManager_.free(ShBlkNorms_raw);
 #endif
-    if(AXRaw != nullptr) memManager_.free(AXRaw);
+#ifdef _FULL_DIRECT
+    memManager_.free(stripRaw);
+    if( not realX )
+      for(auto &X : XRe) if( X != nullptr ) memManager_.free(X);
+#endif
 
 #ifdef _SUB_TIMINGS
     auto botFree = std::chrono::high_resolution_clock::now();
@@ -0,0 +1,592 @@
+/*
+ *  This file is part of the Chronus Quantum (ChronusQ) software package
+ *
+ *  Copyright (C) 2014-2017 Li Research Group (University of Washington)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ *  Contact the Developers:
+ *    E-Mail: xsli@uw.edu
+ *
+ */
+#ifndef __INCLUDED_AOINTEGRALS_CONTRACT_DIRECTKERNELS_HPP__
+#define __INCLUDED_AOINTEGRALS_CONTRACT_DIRECTKERNELS_HPP__
+
+#include <aointegrals.hpp>
+#include <cqlinalg/blas1.hpp>
+
+#include <mutex>
+
+namespace ChronusQ {
+
+  /**
+   *  \brief Handle the fact that std::conj actually returns
+   *  std::complex
+   */
+  template <typename T>
+  inline T SmartConj(const T&);
+
+  template <>
+  inline double SmartConj(const double &x) { return x; }
+  template <>
+  inline dcomplex SmartConj(const dcomplex &x) { return std::conj(x); }
+
+
+
+  /**
+   *  The DirectShellQuartet struct. Describes an evaluated shell quartet
+   *  (s1 s2 | s3 s4) for the DIRECT contraction kernels.
+   */
+  struct DirectShellQuartet {
+
+    size_t n1, n2, n3, n4;     ///< Shell sizes
+    size_t bf1, bf2, bf3, bf4; ///< Starting basis functions of the shells
+    size_t NB;                 ///< Number of basis functions
+
+    double scale;      ///< Scale factor (degeneracy) for the quartet
+    const double *ERI; ///< Raw (n1 n2 | n3 n4) batch in Libint2 order
+
+  }; // struct DirectShellQuartet
+
+
+
+  /**
+   *  The DirectContractionGroup struct. A set of contractions of the same
+   *  kind (hermiticity / contraction type) which are processed together
+   *  by a single DIRECT contraction kernel for every shell quartet.
+   *
+   *  Holds the operators and the thread local row (R) and column (C) shell
+   *  strips of shells 1, 2 and 3 (see AOIntegrals::directScaffold).
+   */
+  template <typename U, typename V>
+  struct DirectContractionGroup {
+
+    std::vector<size_t> iMat; ///< Index of the contraction in the list
+    std::vector<U*>     X;    ///< Operators to contract
+    std::vector<V*>     R1, R2, R3, C1, C2, C3; ///< Shell strips
+
+    bool empty() const { return X.empty(); }
+
+    /**
+     *  \brief Add a contraction to the group. The six strips (R1, R2, R3,
+     *  C1, C2, C3) of length lenStrip are laid out contiguously in strip.
+     */
+    void push_back(size_t i, U *Xi, V *strip, size_t lenStrip) {
+      iMat.push_back(i); X.push_back(Xi);
+      R1.push_back(strip);
+      R2.push_back(strip + lenStrip);
+      R3.push_back(strip + 2*lenStrip);
+      C1.push_back(strip + 3*lenStrip);
+      C2.push_back(strip + 4*lenStrip);
+      C3.push_back(strip + 5*lenStrip);
+    }
+
+  }; // struct DirectContractionGroup
+
+
+
+  /**
+   *  \brief Hermitian Coulomb-type kernel. Operates on the real part of
+   *  the operators (the imaginary part does not contribute).
+   *
+   *  J(1,2) += I * X(4,3),  J(4,3) += I * X(1,2)
+   *
+   *  J(2,1) and J(3,4) are handled on symmetrization after contraction.
+   *
+   *  \tparam NL Size of shell 4 (0 for runtime)
+   */
+  template <size_t NL>
+  inline void DirectJHerKernel(const DirectShellQuartet &Q,
+    DirectContractionGroup<double,double> &grp) {
+
+    const size_t nl   = NL ? NL : Q.n4;
+    const size_t NB   = Q.NB;
+    const size_t nMat = grp.X.size();
+
+    for(size_t m = 0; m < nMat; m++) {
+
+      const double *X  = grp.X[m];
+            double *R1 = grp.R1[m];
+            double *C3 = grp.C3[m];
+
+      const double *Ik = Q.ERI;
+
+      for(size_t i = 0; i < Q.n1; i++)
+      for(size_t j = 0; j < Q.n2; j++) {
+
+        const double X12 = Q.scale * X[Q.bf1 + i + (Q.bf2 + j)*NB];
+        double J12 = 0.;
+
+      for(size_t k = 0; k < Q.n3; k++, Ik += nl) {
+
+        const double *X43 = X  + Q.bf4 + (Q.bf3 + k)*NB;
+              double *J43 = C3 + Q.bf4 + k*NB;
+
+        for(size_t l = 0; l < nl; l++) {
+          J12    += X43[l] * Ik[l];
+          J43[l] += X12    * Ik[l];
+        }
+
+      } // k
+
+        R1[i + (Q.bf2 + j)*Q.n1] += Q.scale * J12;
+
+      } // ij
+
+    } // m
+
+  }; // DirectJHerKernel
+
+
+
+  /**
+   *  \brief Hermitian Exchange-type kernel.
+   *
+   *  K(1,3) += 0.5 * I * CONJ(X(4,2)),  K(4,2) += 0.5 * I * CONJ(X(1,3))
+   *  K(4,1) += 0.5 * I * CONJ(X(2,3)),  K(2,3) += 0.5 * I * CONJ(X(4,1))
+   *
+   *  \tparam NL Size of shell 4 (0 for runtime)
+   */
+  template <size_t NL, typename U, typename V>
+  inline void DirectKHerKernel(const DirectShellQuartet &Q,
+    DirectContractionGroup<U,V> &grp) {
+
+    const size_t nl   = NL ? NL : Q.n4;
+    const size_t NB   = Q.NB;
+    const size_t nMat = grp.X.size();
+    const double fac  = 0.5 * Q.scale;
+
+    for(size_t m = 0; m < nMat; m++) {
+
+      const U *X  = grp.X[m];
+            V *R1 = grp.R1[m], *R2 = grp.R2[m];
+            V *C1 = grp.C1[m], *C2 = grp.C2[m];
+
+      const double *Ik = Q.ERI;
+
+      for(size_t i = 0; i < Q.n1; i++)
+      for(size_t j = 0; j < Q.n2; j++) {
+
+        const U *X42 = X  + Q.bf4 + (Q.bf2 + j)*NB;
+        const U *X41 = X  + Q.bf4 + (Q.bf1 + i)*NB;
+              V *K42 = C2 + Q.bf4 + j*NB;
+              V *K41 = C1 + Q.bf4 + i*NB;
+
+      for(size_t k = 0; k < Q.n3; k++, Ik += nl) {
+
+        const size_t bf3 = Q.bf3 + k;
+
+        const U T1 = fac * SmartConj(X[Q.bf1 + i + bf3*NB]);
+        const U T2 = fac * SmartConj(X[Q.bf2 + j + bf3*NB]);
+
+        V K13 = 0., K23 = 0.;
+
+        for(size_t l = 0; l < nl; l++) {
+          K13    += SmartConj(X42[l]) * Ik[l];
+          K42[l] += T1 * Ik[l];
+          K41[l] += T2 * Ik[l];
+          K23    += SmartConj(X41[l]) * Ik[l];
+        }
+
+        R1[i + bf3*Q.n1] += fac * K13;
+        R2[j + bf3*Q.n2] += fac * K23;
+
+      } // k
+      } // ij
+
+    } // m
+
+  }; // DirectKHerKernel
+
+
+
+  /**
+   *  \brief Non-hermitian Coulomb-type kernel.
+   *
+   *  J(1,2) = J(2,1) += 0.5 * I * (X(4,3) + X(3,4))
+   *  J(3,4) = J(4,3) += 0.5 * I * (X(1,2) + X(2,1))
+   *
+   *  \tparam NL Size of shell 4 (0 for runtime)
+   */
+  template <size_t NL, typename U, typename V>
+  inline void DirectJNonHerKernel(const DirectShellQuartet &Q,
+    DirectContractionGroup<U,V> &grp) {
+
+    const size_t nl   = NL ? NL : Q.n4;
+    const size_t NB   = Q.NB;
+    const size_t nMat = grp.X.size();
+    const double fac  = 0.5 * Q.scale;
+
+    for(size_t m = 0; m < nMat; m++) {
+
+      const U *X  = grp.X[m];
+            V *R1 = grp.R1[m], *R2 = grp.R2[m];
+            V *R3 = grp.R3[m], *C3 = grp.C3[m];
+
+      const double *Ik = Q.ERI;
+
+      for(size_t i = 0; i < Q.n1; i++)
+      for(size_t j = 0; j < Q.n2; j++) {
+
+        const U X12 = fac *
+          (X[Q.bf1 + i + (Q.bf2 + j)*NB] + X[Q.bf2 + j + (Q.bf1 + i)*NB]);
+
+        V J12 = 0.;
+
+      for(size_t k = 0; k < Q.n3; k++, Ik += nl) {
+
+        const U *X43 = X  + Q.bf4 + (Q.bf3 + k)*NB;
+        const U *X34 = X  + Q.bf3 + k + Q.bf4*NB;
+              V *J43 = C3 + Q.bf4 + k*NB;
+              V *J34 = R3 + k + Q.bf4*Q.n3;
+
+        for(size_t l = 0; l < nl; l++) {
+          J12 += (X43[l] + X34[l*NB]) * Ik[l];
+          J43[l]      += X12 * Ik[l];
+          J34[l*Q.n3] += X12 * Ik[l];
+        }
+
+      } // k
+
+        J12 *= fac;
+        R1[i + (Q.bf2 + j)*Q.n1] += J12;
+        R2[j + (Q.bf1 + i)*Q.n2] += J12;
+
+      } // ij
+
+    } // m
+
+  }; // DirectJNonHerKernel
+
+
+
+  /**
+   *  \brief Non-hermitian Exchange-type kernel.
+   *
+   *  K(3,1) += 0.5 * I * X(4,2),  K(4,2) += 0.5 * I * X(3,1)
+   *  K(4,1) += 0.5 * I * X(3,2),  K(3,2) += 0.5 * I * X(4,1)
+   *  K(1,3) += 0.5 * I * X(2,4),  K(2,4) += 0.5 * I * X(1,3)
+   *  K(1,4) += 0.5 * I * X(2,3),  K(2,3) += 0.5 * I * X(1,4)
+   *
+   *  \tparam NL Size of shell 4 (0 for runtime)
+   */
+  template <size_t NL, typename U, typename V>
+  inline void DirectKNonHerKernel(const DirectShellQuartet &Q,
+    DirectContractionGroup<U,V> &grp) {
+
+    const size_t nl   = NL ? NL : Q.n4;
+    const size_t NB   = Q.NB;
+    const size_t nMat = grp.X.size();
+    const double fac  = 0.5 * Q.scale;
+
+    for(size_t m = 0; m < nMat; m++) {
+
+      const U *X  = grp.X[m];
+            V *R1 = grp.R1[m], *R2 = grp.R2[m];
+            V *C1 = grp.C1[m], *C2 = grp.C2[m];
+
+      const double *Ik = Q.ERI;
+
+      for(size_t i = 0; i < Q.n1; i++)
+      for(size_t j = 0; j < Q.n2; j++) {
+
+        const U *X42 = X  + Q.bf4 + (Q.bf2 + j)*NB;
+        const U *X41 = X  + Q.bf4 + (Q.bf1 + i)*NB;
+        const U *X24 = X  + Q.bf2 + j + Q.bf4*NB;
+        const U *X14 = X  + Q.bf1 + i + Q.bf4*NB;
+              V *K42 = C2 + Q.bf4 + j*NB;
+              V *K41 = C1 + Q.bf4 + i*NB;
+              V *K24 = R2 + j + Q.bf4*Q.n2;
+              V *K14 = R1 + i + Q.bf4*Q.n1;
+
+      for(size_t k = 0; k < Q.n3; k++, Ik += nl) {
+
+        const size_t bf3 = Q.bf3 + k;
+
+        const U T1 = fac * X[Q.bf1 + i + bf3*NB];
+        const U T2 = fac * X[Q.bf2 + j + bf3*NB];
+        const U T3 = fac * X[bf3 + (Q.bf1 + i)*NB];
+        const U T4 = fac * X[bf3 + (Q.bf2 + j)*NB];
+
+        V K31 = 0., K32 = 0., K13 = 0., K23 = 0.;
+
+        for(size_t l = 0; l < nl; l++) {
+          K31 += X42[l] * Ik[l];
+          K42[l] += T3 * Ik[l];
+          K41[l] += T4 * Ik[l];
+          K32 += X41[l] * Ik[l];
+          K13 += X24[l*NB] * Ik[l];
+          K24[l*Q.n2] += T1 * Ik[l];
+          K14[l*Q.n1] += T2 * Ik[l];
+          K23 += X14[l*NB] * Ik[l];
+        }
+
+        C1[bf3 + i*NB]   += fac * K31;
+        C2[bf3 + j*NB]   += fac * K32;
+        R1[i + bf3*Q.n1] += fac * K13;
+        R2[j + bf3*Q.n2] += fac * K23;
+
+      } // k
+      } // ij
+
+    } // m
+
+  }; // DirectKNonHerKernel
+
+
+
+  /**
+   *  \brief Contract a shell quartet with all groups of contractions
+   *  for a fixed size of shell 4.
+   */
+  template <size_t NL, typename T, typename G>
+  inline void DirectContractQuartet(const DirectShellQuartet &Q,
+    DirectContractionGroup<double,double> &JHer,
+    DirectContractionGroup<T,G> &KHer,
+    DirectContractionGroup<T,G> &JNonHer,
+    DirectContractionGroup<T,G> &KNonHer) {
+
+    if( not JHer.empty() )    DirectJHerKernel<NL>(Q,JHer);
+    if( not KHer.empty() )    DirectKHerKernel<NL>(Q,KHer);
+    if( not JNonHer.empty() ) DirectJNonHerKernel<NL>(Q,JNonHer);
+    if( not KNonHer.empty() ) DirectKNonHerKernel<NL>(Q,KNonHer);
+
+  }; // DirectContractQuartet
+
+
+
+  /**
+   *  \brief Contract a shell quartet with all groups of contractions.
+   *
+   *  Dispatches the kernels on the size of shell 4 (the innermost,
+   *  contiguous loop) such that the common shell sizes get compile time
+   *  trip counts.
+   */
+  template <typename T, typename G>
+  inline void DirectContractQuartet(const DirectShellQuartet &Q,
+    DirectContractionGroup<double,double> &JHer,
+    DirectContractionGroup<T,G> &KHer,
+    DirectContractionGroup<T,G> &JNonHer,
+    DirectContractionGroup<T,G> &KNonHer) {
+
+    switch( Q.n4 ) {
+      case 1:
+        DirectContractQuartet<1>(Q,JHer,KHer,JNonHer,KNonHer); break;
+      case 3:
+        DirectContractQuartet<3>(Q,JHer,KHer,JNonHer,KNonHer); break;
+      case 5:
+        DirectContractQuartet<5>(Q,JHer,KHer,JNonHer,KNonHer); break;
+      case 6:
+        DirectContractQuartet<6>(Q,JHer,KHer,JNonHer,KNonHer); break;
+      default:
+        DirectContractQuartet<0>(Q,JHer,KHer,JNonHer,KNonHer); break;
+    }
+
+  }; // DirectContractQuartet
+
+
+
+  /**
+   *  \brief Add the columns of shells [tLo,tHi] of a row strip R_s into AX
+   *  and zero them out. Column blocks of AX are guarded by colLocks.
+   */
+  template <typename U, typename G>
+  void DirectFlushRowStrip(U *R, G *AX, const BasisSet &basis,
+    std::vector<std::mutex> &colLocks, size_t s, size_t tLo, size_t tHi) {
+
+    const size_t NB  = basis.nBasis;
+    const size_t ns  = basis.shells[s].size();
+    const size_t bfs = basis.mapSh2Bf[s];
+
+    for(size_t t = tLo; t <= tHi; t++) {
+
+      const size_t bft = basis.mapSh2Bf[t];
+      const size_t nt  = basis.shells[t].size();
+
+      std::lock_guard<std::mutex> lck(colLocks[t]);
+
+      for(size_t nu = bft; nu < bft + nt; nu++)
+      for(size_t i = 0; i < ns; i++) {
+        AX[bfs + i + nu*NB] += R[i + nu*ns];
+        R[i + nu*ns] = 0.;
+      }
+
+    }
+
+  }; // DirectFlushRowStrip
+
+
+
+  /**
+   *  \brief Add the rows [muLo,muHi) of a column strip C_s into AX and
+   *  zero them out. Column blocks of AX are guarded by colLocks.
+   */
+  template <typename U, typename G>
+  void DirectFlushColStrip(U *C, G *AX, const BasisSet &basis,
+    std::vector<std::mutex> &colLocks, size_t s, size_t muLo, size_t muHi) {
+
+    const size_t NB  = basis.nBasis;
+    const size_t ns  = basis.shells[s].size();
+    const size_t bfs = basis.mapSh2Bf[s];
+
+    std::lock_guard<std::mutex> lck(colLocks[s]);
+
+    for(size_t j = 0; j < ns; j++)
+    for(size_t mu = muLo; mu < muHi; mu++) {
+      AX[mu + (bfs + j)*NB] += C[mu + j*NB];
+      C[mu + j*NB] = 0.;
+    }
+
+  }; // DirectFlushColStrip
+
+
+
+  /**
+   *  \brief Group the contractions by kind such that each kind is handled
+   *  by a single (branch free) kernel for all of its operators.
+   *
+   *  \param [in]  list  Contractions
+   *  \param [in]  XRe   Real part of X for the hermitian Coulomb-type
+   *                     contractions (nullptr otherwise)
+   *  \param [in]  strip Thread local strips (6 * lenStrip per contraction)
+   */
+  template <typename T, typename G>
+  void DirectGroupContractions(std::vector<TwoBodyContraction<T,G>> &list,
+    std::vector<double*> &XRe, G *strip, size_t lenStrip,
+    DirectContractionGroup<double,double> &JHer,
+    DirectContractionGroup<T,G> &KHer,
+    DirectContractionGroup<T,G> &JNonHer,
+    DirectContractionGroup<T,G> &KNonHer) {
+
+    for(size_t iMat = 0; iMat < list.size(); iMat++) {
+
+      G *strip_loc = strip + iMat*6*lenStrip;
+      bool isJ = list[iMat].contType == COULOMB;
+
+      if( list[iMat].HER and isJ )
+        JHer.push_back(iMat,XRe[iMat],reinterpret_cast<double*>(strip_loc),
+          lenStrip);
+      else if( list[iMat].HER )
+        KHer.push_back(iMat,list[iMat].X,strip_loc,lenStrip);
+      else if( isJ )
+        JNonHer.push_back(iMat,list[iMat].X,strip_loc,lenStrip);
+      else
+        KNonHer.push_back(iMat,list[iMat].X,strip_loc,lenStrip);
+
+    }
+
+  }; // DirectGroupContractions
+
+
+
+  /**
+   *  \brief Flush the shell 3 strips (Coulomb-type only) once all of the
+   *  quartets (s1 s2 | s3 s4), s4Lo <= s4 <= s4Hi, have been contracted.
+   */
+  template <typename T, typename G>
+  void DirectFlushShell3(std::vector<TwoBodyContraction<T,G>> &list,
+    DirectContractionGroup<double,double> &JHer,
+    DirectContractionGroup<T,G> &JNonHer, const BasisSet &basis,
+    std::vector<std::mutex> &colLocks, size_t s3, size_t s4Lo, 
+    size_t s4Hi) {
+
+    const size_t muLo = basis.mapSh2Bf[s4Lo];
+    const size_t muHi = basis.mapSh2Bf[s4Hi] + basis.shells[s4Hi].size();
+
+    for(auto m = 0; m < JHer.X.size(); m++)
+      DirectFlushColStrip(JHer.C3[m],list[JHer.iMat[m]].AX,basis,colLocks,
+        s3,muLo,muHi);
+
+    for(auto m = 0; m < JNonHer.X.size(); m++) {
+      G *AX = list[JNonHer.iMat[m]].AX;
+      DirectFlushRowStrip(JNonHer.R3[m],AX,basis,colLocks,s3,s4Lo,s4Hi);
+      DirectFlushColStrip(JNonHer.C3[m],AX,basis,colLocks,s3,muLo,muHi);
+    }
+
+  }; // DirectFlushShell3
+
+
+
+  /**
+   *  \brief Flush the shell 1 and 2 strips once all of the quartets 
+   *  (s1 s2 | s3 s4) have been contracted. All of the touched rows / 
+   *  columns belong to shells <= s1.
+   */
+  template <typename T, typename G>
+  void DirectFlushShellPair(std::vector<TwoBodyContraction<T,G>> &list,
+    DirectContractionGroup<double,double> &JHer,
+    DirectContractionGroup<T,G> &KHer,
+    DirectContractionGroup<T,G> &JNonHer,
+    DirectContractionGroup<T,G> &KNonHer, const BasisSet &basis,
+    std::vector<std::mutex> &colLocks, size_t s1, size_t s2) {
+
+    const size_t muHi = basis.mapSh2Bf[s1] + basis.shells[s1].size();
+
+    for(auto m = 0; m < JHer.X.size(); m++)
+      DirectFlushRowStrip(JHer.R1[m],list[JHer.iMat[m]].AX,basis,
+        colLocks,s1,0,s1);
+
+    for(auto m = 0; m < JNonHer.X.size(); m++) {
+      G *AX = list[JNonHer.iMat[m]].AX;
+      DirectFlushRowStrip(JNonHer.R1[m],AX,basis,colLocks,s1,0,s1);
+      DirectFlushRowStrip(JNonHer.R2[m],AX,basis,colLocks,s2,0,s1);
+    }
+
+    for(auto *K : {&KHer, &KNonHer})
+    for(auto m = 0; m < K->X.size(); m++) {
+      G *AX = list[K->iMat[m]].AX;
+      DirectFlushRowStrip(K->R1[m],AX,basis,colLocks,s1,0,s1);
+      DirectFlushRowStrip(K->R2[m],AX,basis,colLocks,s2,0,s1);
+      DirectFlushColStrip(K->C1[m],AX,basis,colLocks,s1,0,muHi);
+      DirectFlushColStrip(K->C2[m],AX,basis,colLocks,s2,0,muHi);
+    }
+
+  }; // DirectFlushShellPair
+
+
+
+  /**
+   *  \brief Complete the strip accumulated contractions: hermitian 
+   *  symmetrization in place, AX = (AX + AX**H) / 2, for hermitian 
+   *  contractions and a scaling by 0.5 otherwise.
+   */
+  template <typename T, typename G>
+  void DirectSymmetrize(std::vector<TwoBodyContraction<T,G>> &list, 
+    size_t NB) {
+
+    for( auto iMat = 0; iMat < list.size();  iMat++ ) {
+
+      G* AX = list[iMat].AX;
+
+      if( list[iMat].HER ) {
+
+        for(size_t j = 0; j < NB; j++) {
+          AX[j + j*NB] = G(0.5) * (AX[j + j*NB] + SmartConj(AX[j + j*NB]));
+          for(size_t i = j+1; i < NB; i++) {
+            G tmp = G(0.5) * (AX[i + j*NB] + SmartConj(AX[j + i*NB]));
+            AX[i + j*NB] = tmp;
+            AX[j + i*NB] = SmartConj(tmp);
+          }
+        }
+
+      } else Scale(NB*NB,G(0.5),AX,1);
+
+    }
+
+  }; // DirectSymmetrize
+
+}; // namespace ChronusQ
+
+#endif
@@ -26,8 +26,10 @@
 
 
 #include <aointegrals.hpp>
+#include <aointegrals/contract/sparsekernels.hpp>
 #include <util/threads.hpp>
 #include <cqlinalg/blas3.hpp>
+#include <cqlinalg/blasext.hpp>
 
 // Use stupid but bullet proof incore contraction for debug
 //#define _BULLET_PROOF_INCORE
@@ -128,6 +130,8 @@ namespace ChronusQ {
 
     #ifdef _BULLET_PROOF_INCORE
 
+    assert( eriStore == DENSE_ERI );
+
     size_t NB3 = basisSet_.nBasis * nSQ_;
 
     // Hermetian code
@@ -155,8 +159,22 @@ namespace ChronusQ {
     #else
 
 
+    // Packed storage
+    if( eriStore == PACKED_ERI ) {
+
+      if(C.HER) JContractPacked(X,AX);
+      else      JContractPacked(reinterpret_cast<T*>(C.X),
+                  reinterpret_cast<T*>(C.AX));
+
+    // Sparse storage
+    } else if( eriStore == SPARSE_ERI ) {
+
+      if(C.HER) JContractSparse(X,AX);
+      else      JContractSparse(reinterpret_cast<T*>(C.X),
+                  reinterpret_cast<T*>(C.AX));
+
     // Hermetian code
-    if(C.HER) {
+    } else if(C.HER) {
 
       Gemm('N','N',nSQ_,1,nSQ_,1.,ERI,nSQ_,X,nSQ_,0.,AX,nSQ_);
 
@@ -193,6 +211,8 @@ namespace ChronusQ {
 
     #ifdef _BULLET_PROOF_INCORE
 
+    assert( eriStore == DENSE_ERI );
+
     for(auto i = 0; i < basisSet_.nBasis; ++i)
     for(auto j = 0; j < basisSet_.nBasis; ++j)
     for(auto k = 0; k < basisSet_.nBasis; ++k)
@@ -204,6 +224,18 @@ namespace ChronusQ {
 
     #else
 
+    // Packed storage
+    if( eriStore == PACKED_ERI ) {
+      KContractPacked(C.X,C.AX);
+      return;
+    }
+
+    // Sparse storage
+    if( eriStore == SPARSE_ERI ) {
+      KContractSparse(C.X,C.AX);
+      return;
+    }
+
     size_t LAThreads = GetLAThreads();
     SetLAThreads(1);
 
@@ -220,6 +252,291 @@ namespace ChronusQ {
 
   }; // AOIntegrals::KContractIncore
 
+
+
+  /**
+   *  \brief Perform a Coulomb-type (34,12) ERI contraction with
+   *  a one-body operator using the PACKED_ERI storage.
+   *
+   *  AX(ij) = sum_{k>=l} (ij|kl) XS(kl), XS(kl) = X(kl) + X(lk) (k != l)
+   *
+   *  Each unique (IJ|KL) is visited once and contributes to both AX(IJ)
+   *  and AX(KL). Threads accumulate into local packed (NB(NB+1)/2) 
+   *  buffers.
+   *
+   *  \param [in]  X  Operator to contract (NB x NB)
+   *  \param [out] AX Contracted operator (NB x NB)
+   */ 
+  template <typename U>
+  void AOIntegrals::JContractPacked(U *X, U *AX) {
+
+    size_t NB = basisSet_.nBasis;
+    size_t nthreads = GetNumThreads();
+
+    U *XS   = memManager_.malloc<U>(nTT_);
+    U *JRaw = memManager_.malloc<U>(nthreads*nTT_);
+    std::fill_n(JRaw,nthreads*nTT_,U(0.));
+
+    // Symmetrized operator in packed storage
+    for(auto k = 0ul, KL = 0ul; k < NB; k++)
+    for(auto l = 0ul; l <= k; l++, KL++)
+      XS[KL] = (k == l) ? X[k + k*NB] : X[k + l*NB] + X[l + k*NB];
+
+    #pragma omp parallel
+    {
+      size_t thread_id = GetThreadID();
+      U *J_loc = JRaw + thread_id*nTT_;
+
+      #pragma omp for schedule(dynamic,16)
+      for(size_t IJ = 0; IJ < nTT_; IJ++) {
+
+        const double *ERIIJ = ERI + IJ*(IJ+1)/2;
+        const U XIJ = XS[IJ];
+        U tmp = ERIIJ[IJ] * XIJ;
+
+        for(size_t KL = 0; KL < IJ; KL++) {
+          tmp         += ERIIJ[KL] * XS[KL];
+          J_loc[KL]   += ERIIJ[KL] * XIJ;
+        }
+
+        J_loc[IJ] += tmp;
+
+      } // loop over IJ
+
+    } // OpenMP context
+
+    // Reduce and unpack
+    for(auto i = 0ul, IJ = 0ul; i < NB; i++)
+    for(auto j = 0ul; j <= i; j++, IJ++) {
+
+      U J = JRaw[IJ];
+      for(auto ithread = 1; ithread < nthreads; ithread++)
+        J += JRaw[IJ + ithread*nTT_];
+
+      AX[i + j*NB] = J;
+      AX[j + i*NB] = J;
+
+    }
+
+    memManager_.free(XS,JRaw);
+
+  }; // AOIntegrals::JContractPacked
+
+
+
+  /**
+   *  \brief Perform an Exchange-type (23,12) ERI contraction with
+   *  a one-body operator using the PACKED_ERI storage.
+   *
+   *  AX(mn) = sum_{kl} (mk|ln) X(kl)
+   *
+   *  Each unique (ij|kl) is scattered into its 8 permutationally
+   *  equivalent contributions, scaled by the appropriate degeneracy
+   *  factor. Threads accumulate into local NB x NB buffers.
+   *
+   *  \param [in]  X  Operator to contract (NB x NB)
+   *  \param [out] AX Contracted operator (NB x NB)
+   */ 
+  template <typename U>
+  void AOIntegrals::KContractPacked(U *X, U *AX) {
+
+    size_t NB = basisSet_.nBasis;
+    size_t nthreads = GetNumThreads();
+
+    U *AXRaw = nullptr;
+    if( nthreads > 1 )
+      AXRaw = memManager_.malloc<U>((nthreads-1)*nSQ_);
+
+    #pragma omp parallel
+    {
+      size_t thread_id = GetThreadID();
+      U *AX_loc = (thread_id == 0) ? AX : AXRaw + (thread_id-1)*nSQ_;
+
+      std::fill_n(AX_loc,nSQ_,U(0.));
+
+      #pragma omp for schedule(dynamic)
+      for(size_t i = 0; i < NB; i++)
+      for(size_t j = 0; j <= i; j++) {
+
+        const size_t IJ = i*(i+1)/2 + j;
+        const double *ERIIJ = ERI + IJ*(IJ+1)/2;
+
+        const double ijDeg = (i == j) ? 0.5 : 1.;
+
+      for(size_t k = 0; k <= i; k++) {
+
+        const size_t lMax = (k == i) ? j : k;
+
+      for(size_t l = 0; l <= lMax; l++) {
+
+        const size_t KL = k*(k+1)/2 + l;
+
+        double v = ijDeg * ERIIJ[KL];
+        if( k == l )   v *= 0.5;
+        if( IJ == KL ) v *= 0.5;
+
+        // AX(a,d) += (ab|cd) X(b,c)
+        AX_loc[i + l*NB] += v * X[j + k*NB]; // (ij|kl)
+        AX_loc[j + l*NB] += v * X[i + k*NB]; // (ji|kl)
+        AX_loc[i + k*NB] += v * X[j + l*NB]; // (ij|lk)
+        AX_loc[j + k*NB] += v * X[i + l*NB]; // (ji|lk)
+        AX_loc[k + j*NB] += v * X[l + i*NB]; // (kl|ij)
+        AX_loc[l + j*NB] += v * X[k + i*NB]; // (lk|ij)
+        AX_loc[k + i*NB] += v * X[l + j*NB]; // (kl|ji)
+        AX_loc[l + i*NB] += v * X[k + j*NB]; // (lk|ji)
+
+      } // l
+      } // k
+      } // ij
+
+    } // OpenMP context
+
+    // Reduce the thread local contributions
+    for(auto ithread = 1; ithread < nthreads; ithread++)
+      MatAdd('N','N',NB,NB,U(1.),AX,NB,U(1.),AXRaw + (ithread-1)*nSQ_,NB,
+        AX,NB);
+
+    if( AXRaw != nullptr ) memManager_.free(AXRaw);
+
+  }; // AOIntegrals::KContractPacked
+
+
+
+  /**
+   *  \brief Perform a Coulomb-type (34,12) ERI contraction with
+   *  a one-body operator using the SPARSE_ERI storage.
+   *
+   *  Loops over the surviving shell quartets of each (s1,s2) pair
+   *  and scatters each integral into its permutationally equivalent
+   *  contributions, scaled by the shell quartet degeneracy factor.
+   *  Threads accumulate into local NB x NB buffers.
+   *
+   *  \param [in]  X  Operator to contract (NB x NB)
+   *  \param [out] AX Contracted operator (NB x NB)
+   */ 
+  template <typename U>
+  void AOIntegrals::JContractSparse(U *X, U *AX) {
+
+    size_t NB = basisSet_.nBasis;
+    size_t NS = basisSet_.nShell;
+    size_t nthreads = GetNumThreads();
+
+    U *AXRaw = nullptr;
+    if( nthreads > 1 )
+      AXRaw = memManager_.malloc<U>((nthreads-1)*nSQ_);
+
+    #pragma omp parallel
+    {
+      size_t thread_id = GetThreadID();
+      U *AX_loc = (thread_id == 0) ? AX : AXRaw + (thread_id-1)*nSQ_;
+
+      std::fill_n(AX_loc,nSQ_,U(0.));
+
+      #pragma omp for schedule(dynamic)
+      for(size_t s1 = 0; s1 < NS; s1++)
+      for(size_t s2 = 0; s2 <= s1; s2++) {
+
+        const size_t n1 = basisSet_.shells[s1].size();
+        const size_t n2 = basisSet_.shells[s2].size();
+        const size_t bf1_s = basisSet_.mapSh2Bf[s1];
+        const size_t bf2_s = basisSet_.mapSh2Bf[s2];
+
+        const double s12_deg = (s1 == s2) ? 0.5 : 1.;
+
+      for(auto &Q : sparseERIIndex[s1*(s1+1)/2 + s2]) {
+
+        double deg = s12_deg;
+        if( Q.s3 == Q.s4 )              deg *= 0.5;
+        if( s1 == Q.s3 and s2 == Q.s4 ) deg *= 0.5;
+
+        DirectShellQuartet SQ = { n1, n2, basisSet_.shells[Q.s3].size(),
+          basisSet_.shells[Q.s4].size(), bf1_s, bf2_s,
+          basisSet_.mapSh2Bf[Q.s3], basisSet_.mapSh2Bf[Q.s4], NB, deg,
+          ERI + Q.offset };
+
+        SparseJKernel(SQ,X,AX_loc);
+
+      } // s34
+      } // s12
+
+    } // OpenMP context
+
+    // Reduce the thread local contributions
+    for(auto ithread = 1; ithread < nthreads; ithread++)
+      MatAdd('N','N',NB,NB,U(1.),AX,NB,U(1.),AXRaw + (ithread-1)*nSQ_,NB,
+        AX,NB);
+
+    if( AXRaw != nullptr ) memManager_.free(AXRaw);
+
+  }; // AOIntegrals::JContractSparse
+
+
+
+  /**
+   *  \brief Perform an Exchange-type (23,12) ERI contraction with
+   *  a one-body operator using the SPARSE_ERI storage.
+   *
+   *  See JContractSparse and KContractPacked.
+   *
+   *  \param [in]  X  Operator to contract (NB x NB)
+   *  \param [out] AX Contracted operator (NB x NB)
+   */ 
+  template <typename U>
+  void AOIntegrals::KContractSparse(U *X, U *AX) {
+
+    size_t NB = basisSet_.nBasis;
+    size_t NS = basisSet_.nShell;
+    size_t nthreads = GetNumThreads();
+
+    U *AXRaw = nullptr;
+    if( nthreads > 1 )
+      AXRaw = memManager_.malloc<U>((nthreads-1)*nSQ_);
+
+    #pragma omp parallel
+    {
+      size_t thread_id = GetThreadID();
+      U *AX_loc = (thread_id == 0) ? AX : AXRaw + (thread_id-1)*nSQ_;
+
+      std::fill_n(AX_loc,nSQ_,U(0.));
+
+      #pragma omp for schedule(dynamic)
+      for(size_t s1 = 0; s1 < NS; s1++)
+      for(size_t s2 = 0; s2 <= s1; s2++) {
+
+        const size_t n1 = basisSet_.shells[s1].size();
+        const size_t n2 = basisSet_.shells[s2].size();
+        const size_t bf1_s = basisSet_.mapSh2Bf[s1];
+        const size_t bf2_s = basisSet_.mapSh2Bf[s2];
+
+        const double s12_deg = (s1 == s2) ? 0.5 : 1.;
+
+      for(auto &Q : sparseERIIndex[s1*(s1+1)/2 + s2]) {
+
+        double deg = s12_deg;
+        if( Q.s3 == Q.s4 )              deg *= 0.5;
+        if( s1 == Q.s3 and s2 == Q.s4 ) deg *= 0.5;
+
+        DirectShellQuartet SQ = { n1, n2, basisSet_.shells[Q.s3].size(),
+          basisSet_.shells[Q.s4].size(), bf1_s, bf2_s,
+          basisSet_.mapSh2Bf[Q.s3], basisSet_.mapSh2Bf[Q.s4], NB, deg,
+          ERI + Q.offset };
+
+        SparseKKernel(SQ,X,AX_loc);
+
+      } // s34
+      } // s12
+
+    } // OpenMP context
+
+    // Reduce the thread local contributions
+    for(auto ithread = 1; ithread < nthreads; ithread++)
+      MatAdd('N','N',NB,NB,U(1.),AX,NB,U(1.),AXRaw + (ithread-1)*nSQ_,NB,
+        AX,NB);
+
+    if( AXRaw != nullptr ) memManager_.free(AXRaw);
+
+  }; // AOIntegrals::KContractSparse
+
 }; // namespace ChronusQ
 
 #endif
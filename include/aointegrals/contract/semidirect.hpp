@@ -0,0 +1,254 @@
+/*
+ *  This file is part of the Chronus Quantum (ChronusQ) software package
+ *
+ *  Copyright (C) 2014-2017 Li Research Group (University of Washington)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ *  Contact the Developers:
+ *    E-Mail: xsli@uw.edu
+ *
+ */
+#ifndef __INCLUDED_AOINTEGRALS_CONTRACT_SEMIDIRECT_HPP__
+#define __INCLUDED_AOINTEGRALS_CONTRACT_SEMIDIRECT_HPP__
+
+#include <aointegrals.hpp>
+#include <aointegrals/contract/directkernels.hpp>
+#include <cqlinalg/blasext.hpp>
+#include <util/threads.hpp>
+
+#include <future>
+
+namespace ChronusQ {
+
+  /**
+   *  \brief Perform various tensor contractions of the ERI tensor
+   *  by replaying the Schwartz screened shell quartets cached on disk
+   *  by AOIntegrals::computeERISemiDirect.
+   *
+   *  Currently supports
+   *    - Coulomb-type (34,12) contractions
+   *    - Exchange-type (23,12) contractions
+   *
+   *  Works with both real and complex matricies
+   *
+   *  The batches are read into two alternating buffers: batch i+1 is
+   *  read asynchronously while batch i is contracted by the OpenMP threads.
+   *
+   *  \param [in/out] list Contains information pertinent to the
+   *    matricies to be contracted with. See TwoBodyContraction
+   *    for details
+   */
+  template <typename T, typename G>
+  void AOIntegrals::twoBodyContractSemiDirect(
+    std::vector<TwoBodyContraction<T,G>> &list) {
+
+    // Evaluate and cache the ERIs if we haven't already
+    if( not semiDirectCached ) computeERISemiDirect();
+
+    // All of the shell quartets were screened
+    if( semiDirectBatches.empty() ) {
+      for(auto &C : list) std::fill_n(C.AX,nSQ_,G(0.));
+      return;
+    }
+
+    size_t nthreads  = GetNumThreads();
+    size_t LAThreads = GetLAThreads();
+
+    SetLAThreads(1); // Turn off parallelism in LA functions
+
+    const size_t NB   = basisSet_.nBasis;
+    const size_t NS   = basisSet_.nShell;
+    const size_t NMat = list.size();
+
+
+    // Map the compound (s1,s2) index to the shell pair
+    std::vector<std::pair<size_t,size_t>> shPairs;
+    for(size_t s1 = 0; s1 < NS; s1++)
+    for(size_t s2 = 0; s2 <= s1; s2++) shPairs.emplace_back(s1,s2);
+
+
+    // Allocate the I/O buffers
+    size_t lenBuffer = std::max_element(semiDirectBatches.begin(),
+      semiDirectBatches.end(),
+      [](const ERICacheBatch &a, const ERICacheBatch &b) {
+        return a.size < b.size;
+      })->size;
+
+    double *ERIBuffer = memManager_.malloc<double>(2*lenBuffer);
+
+
+    // Allocate thread local shell strip storage to accumulate the integral
+    // contractions (see directScaffold). The cached quartets of an (s1,s2)
+    // pair follow the loop order of directScaffold, i.e. the strips of 
+    // shell 3 are flushed once s3 changes and those of shells 1 and 2 once
+    // the pair is done
+    size_t maxShellSize = 
+      std::max_element(basisSet_.shells.begin(),basisSet_.shells.end(),
+        [](const libint2::Shell &sh1, const libint2::Shell &sh2) {
+          return sh1.size() < sh2.size();
+        })->size();
+
+    const size_t lenStrip = maxShellSize * NB;
+
+    G *stripRaw = memManager_.malloc<G>(nthreads*NMat*6*lenStrip);
+    std::fill_n(stripRaw,nthreads*NMat*6*lenStrip,G(0.));
+
+    // Column striped locks for the updates of list[iMat].AX
+    std::vector<std::mutex> colLocks(NS);
+
+    // Hermetian Coulomb-type contractions are carried out in real 
+    // arithmetic
+    const bool realX = std::is_same<T,double>::value;
+
+    std::vector<double*> XRe(NMat,nullptr);
+    for(auto iMat = 0; iMat < NMat; iMat++)
+      if( list[iMat].HER and list[iMat].contType == COULOMB ) {
+
+        if( realX ) XRe[iMat] = reinterpret_cast<double*>(list[iMat].X);
+        else {
+          XRe[iMat] = memManager_.malloc<double>(NB*NB);
+          for(auto k = 0; k < NB*NB; k++) 
+            XRe[iMat][k] = std::real(list[iMat].X[k]);
+        }
+
+      }
+
+    for(auto iMat = 0; iMat < NMat; iMat++)
+      std::fill_n(list[iMat].AX,nSQ_,G(0.));
+
+    // Group the contractions of each thread by kind
+    std::vector<DirectContractionGroup<double,double>> JHer(nthreads);
+    std::vector<DirectContractionGroup<T,G>> KHer(nthreads), 
+      JNonHer(nthreads), KNonHer(nthreads);
+
+    for(auto ithread = 0; ithread < nthreads; ithread++)
+      DirectGroupContractions(list,XRe,stripRaw + ithread*NMat*6*lenStrip,
+        lenStrip,JHer[ithread],KHer[ithread],JNonHer[ithread],
+        KNonHer[ithread]);
+
+
+    std::ifstream scrFile(scrFileName,std::ios::binary);
+    if( not scrFile.good() )
+      CErr("Unable to open SEMIDIRECT scratch file " + scrFileName);
+
+    auto readBatch = [&](size_t iBatch) -> void {
+      auto &batch = semiDirectBatches[iBatch];
+      scrFile.seekg(batch.offset * sizeof(double));
+      scrFile.read(reinterpret_cast<char*>(ERIBuffer + (iBatch%2)*lenBuffer),
+        batch.size * sizeof(double));
+    };
+
+    // Prefetch the first batch
+    std::future<void> pendingRead =
+      std::async(std::launch::async,readBatch,0);
+
+    for(size_t iBatch = 0; iBatch < semiDirectBatches.size(); iBatch++) {
+
+      // Wait for the current batch, then prefetch the next one
+      pendingRead.get();
+      if( scrFile.fail() )
+        CErr("Failed to read SEMIDIRECT scratch file " + scrFileName);
+
+      if( iBatch + 1 < semiDirectBatches.size() )
+        pendingRead = std::async(std::launch::async,readBatch,iBatch+1);
+
+      auto &batch = semiDirectBatches[iBatch];
+      const double *buffer = ERIBuffer + (iBatch % 2) * lenBuffer;
+
+      #pragma omp parallel
+      {
+
+      size_t thread_id = GetThreadID();
+
+      auto &JHer_loc    = JHer[thread_id];
+      auto &KHer_loc    = KHer[thread_id];
+      auto &JNonHer_loc = JNonHer[thread_id];
+      auto &KNonHer_loc = KNonHer[thread_id];
+
+      #pragma omp for schedule(dynamic)
+      for(size_t s12 = batch.s12Start; s12 < batch.s12End; s12++) {
+
+        if( sparseERIIndex[s12].empty() ) continue;
+
+        const size_t s1 = shPairs[s12].first;
+        const size_t s2 = shPairs[s12].second;
+
+        const size_t n1 = basisSet_.shells[s1].size();
+        const size_t n2 = basisSet_.shells[s2].size();
+        const size_t bf1_s = basisSet_.mapSh2Bf[s1];
+        const size_t bf2_s = basisSet_.mapSh2Bf[s2];
+
+        // Degeneracy factor for s1,s2 pair
+        const double s12_deg = (s1 == s2) ? 1.0 : 2.0;
+
+        // Shell 3 of the strips being accumulated and the range of shell 4 
+        size_t s3Cur = sparseERIIndex[s12].front().s3;
+        size_t s4Lo = NS, s4Hi = 0;
+
+      for(auto &Q : sparseERIIndex[s12]) {
+
+        if( Q.s3 != s3Cur ) {
+          DirectFlushShell3(list,JHer_loc,JNonHer_loc,basisSet_,colLocks,
+            s3Cur,s4Lo,s4Hi);
+          s3Cur = Q.s3; s4Lo = NS; s4Hi = 0;
+        }
+
+        s4Lo = std::min(s4Lo,Q.s4); s4Hi = std::max(s4Hi,Q.s4);
+
+        // Total degeneracy factor
+        double s34_deg = (Q.s3 == Q.s4) ? 1.0 : 2.0;
+        double s12_34_deg = (s1 == Q.s3) ? (s2 == Q.s4 ? 1.0 : 2.0) : 2.0;
+        double s1234_deg = s12_deg * s34_deg * s12_34_deg;
+
+        const DirectShellQuartet SQ = { n1, n2, basisSet_.shells[Q.s3].size(),
+          basisSet_.shells[Q.s4].size(), bf1_s, bf2_s,
+          basisSet_.mapSh2Bf[Q.s3], basisSet_.mapSh2Bf[Q.s4], NB, 
+          0.5*s1234_deg, buffer + Q.offset - batch.offset };
+
+        DirectContractQuartet(SQ,JHer_loc,KHer_loc,JNonHer_loc,KNonHer_loc);
+
+      } // s34
+
+        DirectFlushShell3(list,JHer_loc,JNonHer_loc,basisSet_,colLocks,
+          s3Cur,s4Lo,s4Hi);
+        DirectFlushShellPair(list,JHer_loc,KHer_loc,JNonHer_loc,KNonHer_loc,
+          basisSet_,colLocks,s1,s2);
+
+      } // s12
+
+      } // OpenMP context
+
+    } // loop over batches
+
+    scrFile.close();
+
+
+    DirectSymmetrize(list,NB);
+
+
+    // Free scratch space
+    memManager_.free(ERIBuffer,stripRaw);
+    if( not realX )
+      for(auto &X : XRe) if( X != nullptr ) memManager_.free(X);
+
+    // Turn threads for LA back on
+    SetLAThreads(LAThreads);
+
+  }; // AOIntegrals::twoBodyContractSemiDirect
+
+}; // namespace ChronusQ
+
+#endif
@@ -0,0 +1,115 @@
+/*
+ *  This file is part of the Chronus Quantum (ChronusQ) software package
+ *
+ *  Copyright (C) 2014-2017 Li Research Group (University of Washington)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ *  Contact the Developers:
+ *    E-Mail: xsli@uw.edu
+ *
+ */
+#ifndef __INCLUDED_AOINTEGRALS_CONTRACT_SPARSEKERNELS_HPP__
+#define __INCLUDED_AOINTEGRALS_CONTRACT_SPARSEKERNELS_HPP__
+
+#include <aointegrals/contract/directkernels.hpp>
+
+namespace ChronusQ {
+
+  /**
+   *  \brief Coulomb-type (34,12) contraction of a single stored shell
+   *  quartet (12|34) with a one-body operator.
+   *
+   *  Scatters each integral into its 8 permutationally equivalent
+   *  contributions, scaled by the quartet degeneracy (Q.scale). Used by
+   *  the SPARSE_ERI INCORE contraction engine.
+   *
+   *  \param [in]     Q  Shell quartet (sizes, offsets and integrals)
+   *  \param [in]     X  Operator to contract (NB x NB)
+   *  \param [in/out] AX Contracted operator (NB x NB)
+   */
+  template <typename T, typename G>
+  inline void SparseJKernel(const DirectShellQuartet &Q, const T *X, G *AX) {
+
+    const size_t NB = Q.NB;
+
+    for(size_t i = 0, bf1 = Q.bf1, ijkl = 0; i < Q.n1; i++, bf1++)
+    for(size_t j = 0, bf2 = Q.bf2; j < Q.n2; j++, bf2++) {
+
+      const T X12 = X[bf1 + bf2*NB] + X[bf2 + bf1*NB];
+      G J12 = 0.;
+
+    for(size_t k = 0, bf3 = Q.bf3; k < Q.n3; k++, bf3++)
+    for(size_t l = 0, bf4 = Q.bf4; l < Q.n4; l++, bf4++, ijkl++) {
+
+      const double v = Q.scale * Q.ERI[ijkl];
+
+      // J(1,2) += I * (X(3,4) + X(4,3))
+      J12 += v * (X[bf3 + bf4*NB] + X[bf4 + bf3*NB]);
+
+      // J(3,4) = J(4,3) += I * (X(1,2) + X(2,1))
+      AX[bf3 + bf4*NB] += v * X12;
+      AX[bf4 + bf3*NB] += v * X12;
+
+    } // kl
+
+      AX[bf1 + bf2*NB] += J12;
+      AX[bf2 + bf1*NB] += J12;
+
+    } // ij
+
+  }; // SparseJKernel
+
+
+
+  /**
+   *  \brief Exchange-type (23,12) contraction of a single stored shell
+   *  quartet (12|34) with a one-body operator.
+   *
+   *  See SparseJKernel.
+   *
+   *  \param [in]     Q  Shell quartet (sizes, offsets and integrals)
+   *  \param [in]     X  Operator to contract (NB x NB)
+   *  \param [in/out] AX Contracted operator (NB x NB)
+   */
+  template <typename T, typename G>
+  inline void SparseKKernel(const DirectShellQuartet &Q, const T *X, G *AX) {
+
+    const size_t NB = Q.NB;
+
+    for(size_t i = 0, bf1 = Q.bf1, ijkl = 0; i < Q.n1; i++, bf1++)
+    for(size_t j = 0, bf2 = Q.bf2; j < Q.n2; j++, bf2++)
+    for(size_t k = 0, bf3 = Q.bf3; k < Q.n3; k++, bf3++)
+    for(size_t l = 0, bf4 = Q.bf4; l < Q.n4; l++, bf4++, ijkl++) {
+
+      const double v = Q.scale * Q.ERI[ijkl];
+
+      // AX(a,d) += (ab|cd) X(b,c)
+      AX[bf1 + bf4*NB] += v * X[bf2 + bf3*NB]; // (12|34)
+      AX[bf2 + bf4*NB] += v * X[bf1 + bf3*NB]; // (21|34)
+      AX[bf1 + bf3*NB] += v * X[bf2 + bf4*NB]; // (12|43)
+      AX[bf2 + bf3*NB] += v * X[bf1 + bf4*NB]; // (21|43)
+      AX[bf3 + bf2*NB] += v * X[bf4 + bf1*NB]; // (34|12)
+      AX[bf4 + bf2*NB] += v * X[bf3 + bf1*NB]; // (43|12)
+      AX[bf3 + bf1*NB] += v * X[bf4 + bf2*NB]; // (34|21)
+      AX[bf4 + bf1*NB] += v * X[bf3 + bf2*NB]; // (43|21)
+
+    } // ijkl
+
+  }; // SparseKKernel
+
+}; // namespace ChronusQ
+
+#endif
@@ -32,6 +32,19 @@ namespace ChronusQ {
   void Gemm(char TRANSA, char TRANSB, int M, int N, int K, _FScale ALPHA,
     _F1 *A, int LDA, _F2 *B, int LDB, _FScale BETA, _F2 *C, int LDC);
 
+  /**
+   *  \brief Solves a triangular matrix equation op(A) X = alpha B or
+   *  X op(A) = alpha B in place of B. Smart wrapper around DTRSM or
+   *  ZTRSM depending on context.
+   *
+   *  See http://www.netlib.org/lapack/lapack-3.1.1/html/dtrsm.f.html or
+   *      http://www.netlib.org/lapack/lapack-3.1.1/html/ztrsm.f.html for
+   *  parameter documentation.
+   */ 
+  template <typename _F>
+  void Trsm(char SIDE, char UPLO, char TRANSA, char DIAG, int M, int N,
+    _F ALPHA, _F *A, int LDA, _F *B, int LDB);
+
   /**
    *  \brief Returns constant time a vector plus a vector
    *
@@ -49,6 +49,15 @@ namespace ChronusQ {
 
   // Hermetian Eigenproblem
 
+  /**
+   *  Hermetian eigensolver backends
+   */ 
+  enum HERMETIAN_EIGEN_ALG {
+    QR_EIGEN,   ///< QR iteration (DSYEV / ZHEEV)
+    DC_EIGEN,   ///< Divide and conquer (DSYEVD / ZHEEVD)
+    MRRR_EIGEN  ///< Relatively robust representations (DSYEVR / ZHEEVR)
+  };
+
   /**
    *  \brief Smart wrapper around DSYEV and ZHEEV depending on context.
    *
@@ -81,6 +90,31 @@ namespace ChronusQ {
   int HermetianEigen(char JOBZ, char UPLO, int N, _F *A, int LDA, dcomplex *W,
     CQMemManager &mem);
 
+  /**
+   *  \brief Smart wrapper around DSYEV(D,R) and ZHEEV(D,R) depending on 
+   *  context.
+   *
+   *  Same as above, but with a selectable backend (see HERMETIAN_EIGEN_ALG).
+   */ 
+  template <typename _F>
+  int HermetianEigen(HERMETIAN_EIGEN_ALG ALG, char JOBZ, char UPLO, int N, 
+    _F *A, int LDA, double *W, CQMemManager &mem);
+
+  /**
+   *  \brief Smart wrapper around DSYEVR and ZHEEVR depending on context.
+   *
+   *  Obtains the lowest NEIG eigenpairs of a hermetian matrix (partial
+   *  spectrum). On exit, the eigenvectors are stored in the first NEIG 
+   *  columns of A (the rest of A is destroyed) and the eigenvalues in the
+   *  first NEIG elements of W.
+   *
+   *  See http://www.netlib.org/lapack/explore-html/d2/d8a/group__double_s_yeigen.html
+   *  for parameter documentation.
+   */ 
+  template <typename _F>
+  int HermetianEigen(char JOBZ, char UPLO, int N, int NEIG, _F *A, int LDA, 
+    double *W, CQMemManager &mem);
+
 
 
 
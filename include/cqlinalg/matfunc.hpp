@@ -32,10 +32,26 @@ namespace ChronusQ {
   void MatExp(char ALG, size_t N, _FExp ALPHA, _F1 *A, size_t LDA, 
     _F2 *ExpA, size_t LDEXPA, CQMemManager &mem);
 
+  template <typename _F>
+  void MatExpTaylor(size_t N, _F *A, size_t LDA, _F *ExpA, size_t LDEXPA,
+    CQMemManager &mem);
+
   template <typename _F1, typename _F2, typename _FC>
   void MatSeries(size_t NC, size_t N, _F1 *A, size_t LDA, _F2 *B,
     size_t LDB, _FC *C);
 
+  /**
+   *  Density matrix purification schemes
+   */ 
+  enum PURIFICATION_ALG {
+    CANONICAL_PURIFICATION, ///< Palser--Manolopoulos canonical purification
+    TRS4_PURIFICATION       ///< Niklasson trace resetting (4th order)
+  };
+
+  template <typename _F>
+  int Purify(PURIFICATION_ALG ALG, size_t N, size_t NOCC, _F *F, size_t LDF,
+    _F *P, size_t LDP, double TOL, size_t MAXITER, _F *SCR);
+
 }; // namespace ChronusQ
 
 #endif
@@ -46,8 +46,8 @@ namespace ChronusQ {
     //  out vsigma[1]  = UP   DOWN  first part der of the energy per unit volume in terms of sigma 
     //  out vsigma[2]  = DOWN DOWN  first part der of the energy per unit volume in terms of sigma 
     //  out fxc/v2rho2[0]  = UP UP      second part der of the energy per unit volume in terms of the dens 
-    //  out fxc/v2rho2[1]  = UP UP      second part der of the energy per unit volume in terms of the dens 
-    //  out fxc/v2rho2[2]  = UP UP      second part der of the energy per unit volume in terms of the dens 
+    //  out fxc/v2rho2[1]  = UP DOWN    second part der of the energy per unit volume in terms of the dens 
+    //  out fxc/v2rho2[2]  = DOWN DOWN  second part der of the energy per unit volume in terms of the dens 
     //  out v2rhosigma[0]  = UP   - UP UP     second part der of the energy per unit volume in terms of the dens and sigma 
     //  out v2rhosigma[1]  = UP   - UP DOWN   second part der of the energy per unit volume in terms of the dens and sigma 
     //  out v2rhosigma[2]  = UP   - DOWN DOWN second part der of the energy per unit volume in terms of the dens and sigma 
@@ -92,13 +92,24 @@ namespace ChronusQ {
 
     };
 
-/*
-    virtual void evalFXC(size_t N, double *rho, double *fxc) = 0;
-    virtual void evalFXC(size_t N, double *rho, double *sigma, double *v2rho2, double *v2rhosigma, double *v2sigma2) = 0;
-*/
+    void evalFXC(size_t N, double *rho, double *v2rho2) {
+      assert(not isGGA_);
+      xc_lda_fxc(&this->functional_,N,rho,v2rho2);
+    }
+
+    void evalFXC(size_t N, double *rho, double *sigma, double *v2rho2, 
+      double *v2rhosigma, double *v2sigma2) {
+
+      assert(isGGA_);
+      xc_gga_fxc(&this->functional_,N,rho,sigma,v2rho2,v2rhosigma,v2sigma2);
+
+    };
 
     bool isGGA() { return this->isGGA_; }
 
+    /// Density below which LibXC zeroes the kernel
+    double densityThreshold() const { return functional_.dens_threshold; }
+
   }; // class DFTFunctional
 
 
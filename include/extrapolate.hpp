@@ -25,6 +25,7 @@
 #define __INCLUDED_EXTRAPOLATE_HPP__
 
 #include <chronusq_sys.hpp>
+#include <functional>
 #include <cqlinalg/solve.hpp>
 
 namespace ChronusQ {
@@ -52,6 +53,7 @@ namespace ChronusQ {
     size_t         OSize;       ///< Size of the error metrics used to construct B
     std::vector<T> coeffs;      ///< Vector of extrapolation coeficients
     oper_t_coll2   errorMetric; ///< Vector of vectors containing error metrics
+    std::vector<T> errorGram;   ///< Precomputed <e(k),e(j)> (optional)
 
     // Constructor
       
@@ -71,6 +73,26 @@ namespace ChronusQ {
 
     };
 
+    /**
+     *  DIIS Constructor. Constructs a DIIS object from a precomputed
+     *  matrix of error metric inner products (e.g. one that is updated 
+     *  incrementally as new error metrics become available)
+     *
+     *  \param [in]  nExtrap Size of extrapolation space
+     *  \param [in]  B       Inner products of the error metrics, 
+     *                       B(k,j) = <e(k),e(j)>
+     *  \param [in]  LDB     Leading dimension of B
+     */ 
+    DIIS(size_t nExtrap, const T *B, size_t LDB) :
+      nExtrap(nExtrap), nMat(0), OSize(0), errorGram(nExtrap*nExtrap) {
+
+      coeffs.resize(nExtrap+1);
+
+      for(auto j = 0ul; j < nExtrap; j++)
+        std::copy_n(B + j*LDB,nExtrap,&errorGram[j*nExtrap]);
+
+    };
+
 
     // Constructors for default, copy, and move
     DIIS() = delete; 
@@ -86,7 +108,7 @@ namespace ChronusQ {
 
   /**
    *  \brief Performs a DIIS extrapolation using the vectors stored 
-   *  in errorMetric
+   *  in errorMetric (or their precomputed inner products in errorGram)
    *
    */ 
   template<typename T>
@@ -98,16 +120,24 @@ namespace ChronusQ {
     std::vector<T>   B(N*N,0);
 
     // Build the B matrix
-    for(auto i = 0ul; i < nMat; i++){ 
+    if( not errorGram.empty() ) {
       for(auto j = 0ul; j < nExtrap; j++){
-        for(auto k = 0ul; k <= j; k++){
-          B[k+j*N] += InnerProd<T>(OSize,errorMetric[k][i],1,errorMetric[j][i],1);
+        for(auto k = 0ul; k < nExtrap; k++){
+          B[k+j*N] = errorGram[k+j*nExtrap];
         }
       }
-    }
-    for(auto j = 0ul; j < nExtrap; j++){
-      for(auto k = 0ul; k < j; k++){
-         B[j+k*N] = B[k+j*N];
+    } else {
+      for(auto i = 0ul; i < nMat; i++){ 
+        for(auto j = 0ul; j < nExtrap; j++){
+          for(auto k = 0ul; k <= j; k++){
+            B[k+j*N] += InnerProd<T>(OSize,errorMetric[k][i],1,errorMetric[j][i],1);
+          }
+        }
+      }
+      for(auto j = 0ul; j < nExtrap; j++){
+        for(auto k = 0ul; k < j; k++){
+           B[j+k*N] = B[k+j*N];
+        }
       }
     }
     for(auto l = 0ul; l < nExtrap; l++){
@@ -133,6 +163,115 @@ namespace ChronusQ {
   }; // function DIIS
 
 
+
+  /**
+   *  \brief Minimizes a quadratic model over the convex combinations of
+   *  a set of N vectors,
+   *
+   *    min_c f(c) = g**T c + 0.5 * c**T H c,  c >= 0,  sum_i c_i = 1,
+   *
+   *  by projected gradient descent, as required by the energy based DIIS 
+   *  schemes (EDIIS / ADIIS). H need not be positive definite, in which 
+   *  case the lowest of the local minima reached from c and from each of
+   *  the vertices is returned.
+   *
+   *  \param [in]     N       Number of coefficients
+   *  \param [in]     g       Linear term (N)
+   *  \param [in]     H       Symmetric quadratic term (N x N)
+   *  \param [in/out] c       On entry, the starting point (need not be
+   *                          feasible). On exit, the minimizing coefficients
+   *  \param [in]     maxIter Maximum number of iterations
+   *  \param [in]     tol     Convergence tolerance on the change in c
+   */ 
+  inline void SimplexQuadMin(size_t N, const double *g, const double *H,
+    double *c, size_t maxIter = 1000, double tol = 1e-12) {
+
+    // Projects x onto the unit simplex (sort based)
+    std::vector<double> u(N);
+    auto project = [&](double *x) {
+
+      std::copy_n(x,N,u.begin());
+      std::sort(u.begin(),u.end(),std::greater<double>());
+
+      double cSum = 0., theta = 0.;
+      for(auto j = 0; j < N; j++) {
+        cSum += u[j];
+        double t = (cSum - 1.) / (j + 1);
+        if( u[j] - t > 0. ) theta = t;
+      }
+
+      for(auto j = 0; j < N; j++) x[j] = std::max(x[j] - theta, 0.);
+
+    };
+
+    // Step size from the bound on the curvature, |H|_2 <= |H|_F
+    double L = 0.;
+    for(auto j = 0; j < N*N; j++) L += H[j] * H[j];
+    L = std::sqrt(L);
+
+    auto f = [&](const double *x) {
+      double val = 0.;
+      for(auto i = 0; i < N; i++) {
+        val += g[i] * x[i];
+        for(auto j = 0; j < N; j++) val += 0.5 * x[i] * H[i + j*N] * x[j];
+      }
+      return val;
+    };
+
+    // Local descent from x
+    std::vector<double> xOld(N);
+    auto descend = [&](double *x) {
+
+      project(x);
+
+      for(auto iter = 0; iter < maxIter; iter++) {
+
+        std::copy_n(x,N,xOld.begin());
+
+        // Descend along the gradient g + H x, linear models are minimized
+        // at a vertex
+        for(auto i = 0; i < N; i++) {
+          double grad = g[i];
+          for(auto j = 0; j < N; j++) grad += H[i + j*N] * xOld[j];
+
+          if( L > 0. ) x[i] -= grad / L;
+          else         x[i] = -grad;
+        }
+
+        if( L <= 0. ) {
+          auto iMin = std::max_element(x,x + N) - x;
+          std::fill_n(x,N,0.); x[iMin] = 1.;
+          break;
+        }
+
+        project(x);
+
+        double dx = 0.;
+        for(auto j = 0; j < N; j++) dx = std::max(dx,std::abs(x[j] - xOld[j]));
+        if( dx < tol ) break;
+
+      }
+
+    };
+
+    // The model need not be convex, also descend from each of the vertices
+    // and keep the lowest minimum
+    descend(c);
+    double fMin = f(c);
+
+    std::vector<double> x(N);
+    for(auto k = 0; k < N; k++) {
+
+      std::fill(x.begin(),x.end(),0.); x[k] = 1.;
+      descend(&x[0]);
+
+      double fx = f(&x[0]);
+      if( fx < fMin ) { fMin = fx; std::copy_n(x.begin(),N,c); }
+
+    }
+
+  }; // SimplexQuadMin
+
 }; // namespace ChronusQ
 
 #endif
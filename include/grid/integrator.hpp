@@ -404,16 +404,14 @@ namespace ChronusQ {
       std::cerr << "CENTER { "<< Center[0] <<" , " << Center[1] <<" , " << Center[2] <<" }, " << std::endl; 
 #endif
 
-      size_t nthreads = GetNumThreads();
-
       #pragma omp parallel
       {
-      
-      size_t thread_id = GetThreadID();
 
-      for(size_t iBatch = 0; iBatch < nBatches; iBatch++){
+      // Thread local result (reduced below)
+      T resLoc(0.);
 
-        if( iBatch % nthreads != thread_id ) continue;
+      #pragma omp for schedule(dynamic)
+      for(size_t iBatch = 0; iBatch < nBatches; iBatch++){
 
         size_t Jst = iBatch * nRadPerMacroBatch;
         size_t Jend = Jst + nRadPerMacroBatch - 1;
@@ -423,10 +421,13 @@ namespace ChronusQ {
 
         std::pair<double,double> rBounds{Scale*this->q1.pts[Jst], Scale*this->q1.pts[Jend]};
 
-        // FIXME: This will cause a race condition for scalar integration
-        BatchIntegrator(res,func,batchPt,batchW,rBounds,args...);
+        BatchIntegrator(resLoc,func,batchPt,batchW,rBounds,args...);
 
       }
+
+      #pragma omp critical
+      res += resLoc;
+
       }
       res *= SCALE;
     }; // Integrate
@@ -457,6 +458,165 @@ namespace ChronusQ {
 
 
 
+  /**
+   *  \brief Atomic partition (fuzzy cell) schemes for the molecular grid
+   */ 
+  enum PARTITION_SCHEME {
+    BECKE_PARTITION, ///< J. Chem. Phys. 88, 2547 (1988)
+    SSF_PARTITION    ///< Chem. Phys. Lett. 257, 213 (1996)
+  };
+
+  /**
+   *  \brief A batch of points of the molecular grid along with the 
+   *  (density independent) quantities required for its integration.
+   */
+  struct GridBatch {
+
+    size_t iAtm;                 ///< Atomic center of the batch
+    std::vector<cart_t> pts;     ///< Points
+    std::vector<double> weights; ///< Final (partitioned) weights
+
+    size_t              NBE;        ///< # of significant basis functions
+    std::vector<bool>   evalShell;  ///< Whether a shell is significant
+    std::vector<size_t> evalShells; ///< List of the significant shells
+
+    std::vector<std::pair<size_t,size_t>> subMat; 
+      ///< Contiguous basis function ranges of the significant shells
+
+    double *basisEval   = nullptr; ///< Cached basis (nullptr if not cached)
+    size_t lenBasisEval = 0;       ///< Length of the cached basis
+
+  }; // struct GridBatch
+
+
+  /**
+   *  \brief The molecular grid.
+   *
+   *  Holds the (screened) batches of points generated by the 
+   *  BeckeIntegrator. These only depend on the geometry and the integration
+   *  parameters, so the grid is built once and shared by all of the 
+   *  subsequent integrations (SCF and RT steps).
+   */
+  struct MolecularGrid {
+
+    std::vector<GridBatch> batches; ///< Batches of points
+    std::vector<size_t>    schedule; ///< Batch indices by decreasing cost
+
+    // Key of the grid
+    std::vector<double> geometry;  ///< Atomic coordinates
+    size_t nRad      = 0;          ///< # Radial points
+    size_t nAng      = 0;          ///< # Angular points
+    size_t nRadBatch = 0;          ///< # Radial points per batch
+    double epsScreen = 0.;         ///< Screening tolerance
+    PARTITION_SCHEME scheme = BECKE_PARTITION; ///< Partition scheme
+    bool prune = false;            ///< Whether the grid is pruned
+    bool boxBatch = false;         ///< Whether the points are batched in boxes
+
+    size_t basisCacheBytes = 0;    ///< Size of the cached basis (bytes)
+    size_t basisCacheNDer  = 0;    ///< # derivatives in the cached basis
+    CQMemManager *basisCacheMemManager = nullptr; 
+      ///< Memory manager which owns the cached basis
+
+    // The cached basis is owned by the grid
+    MolecularGrid()                                 = default;
+    MolecularGrid(const MolecularGrid &)            = delete;
+    MolecularGrid& operator=(const MolecularGrid &) = delete;
+
+    ~MolecularGrid() { clearBasisCache(basisCacheNDer); }
+
+    /**
+     *  \brief Drops (frees) the cached basis of all batches.
+     *
+     *  \param [in] NDer # derivatives of the subsequent cache
+     */ 
+    void clearBasisCache(size_t NDer) {
+      for(auto &b : batches) 
+        if( b.basisEval ) {
+          basisCacheMemManager->free(b.basisEval);
+          b.basisEval    = nullptr;
+          b.lenBasisEval = 0;
+        }
+      basisCacheBytes = 0;
+      basisCacheNDer  = NDer;
+    };
+
+    /**
+     *  \brief Orders the batches by decreasing (estimated) cost, 
+     *  NPts * NBE^2 (the cost of the batch VXC / density GEMMs), for the
+     *  dynamic scheduling of the integration.
+     */ 
+    void makeSchedule() {
+
+      schedule.resize(batches.size());
+      std::iota(schedule.begin(),schedule.end(),0);
+
+      auto cost = [&](size_t i) {
+        return double(batches[i].pts.size()) * batches[i].NBE * batches[i].NBE;
+      };
+
+      std::stable_sort(schedule.begin(),schedule.end(),
+        [&](size_t i, size_t j){ return cost(i) > cost(j); });
+
+    }; // makeSchedule
+
+    /**
+     *  \brief Maximum number of significant basis functions in a batch
+     */ 
+    size_t maxNBE() const {
+      size_t n = 0;
+      for(auto &b : batches) n = std::max(n,b.NBE);
+      return n;
+    };
+
+    /**
+     *  \brief Total number of (significant) points in the grid
+     */ 
+    size_t nPts() const {
+      size_t n = 0;
+      for(auto &b : batches) n += b.pts.size();
+      return n;
+    };
+
+    /**
+     *  \brief Whether the grid is valid for a particular geometry and set
+     *  of integration parameters.
+     */ 
+    bool isValid(const Molecule &mol, size_t nR, size_t nA, size_t nRB,
+      double eps, PARTITION_SCHEME sch, bool prn, bool box) const {
+
+      if( nR != nRad or nA != nAng or nRB != nRadBatch or eps != epsScreen or
+          sch != scheme or prn != prune or box != boxBatch )
+        return false;
+
+      if( geometry.size() != 3*mol.nAtoms ) return false;
+      for(auto iAtm = 0; iAtm < mol.nAtoms; iAtm++)
+      for(auto k = 0; k < 3; k++)
+        if( geometry[3*iAtm + k] != mol.atoms[iAtm].coord[k] ) return false;
+
+      return true;
+
+    }; // isValid
+
+    /**
+     *  \brief Store the key (geometry and integration parameters) of the 
+     *  grid.
+     */ 
+    void setKey(const Molecule &mol, size_t nR, size_t nA, size_t nRB,
+      double eps, PARTITION_SCHEME sch, bool prn, bool box) {
+
+      nRad = nR; nAng = nA; nRadBatch = nRB; epsScreen = eps; scheme = sch;
+      prune = prn; boxBatch = box;
+
+      geometry.clear();
+      for(auto &atom : mol.atoms)
+        geometry.insert(geometry.end(),atom.coord.begin(),atom.coord.end());
+
+    }; // setKey
+
+  }; // struct MolecularGrid
+
+
+
   /**
    *  \brief Becke Molecular Integrator
    *
@@ -468,8 +628,6 @@ namespace ChronusQ {
   template <class _QTyp1>
   class BeckeIntegrator : public SphereIntegrator<_QTyp1> {
 
-    size_t iAtm; ///< Current center for integral
-
   protected:
  
     CQMemManager     &memManager_; ///< Memory managment
@@ -479,6 +637,21 @@ namespace ChronusQ {
     double           epsScreen_;   ///< Raw screening tolerance
     size_t           NDer;         ///< Number of required basis set derivatives
 
+    PARTITION_SCHEME scheme_;      ///< Atomic partition scheme
+    bool             prune_;       ///< Whether to prune the angular grids
+    bool             boxBatch_;    ///< Whether to batch the points in boxes
+    size_t           basisCacheMem_; ///< Memory for the basis cache (bytes)
+
+    std::map<size_t,Lebedev> angGrids_; ///< Lebedev grids of the pruned regions
+
+    std::shared_ptr<MolecularGrid> grid_; ///< Molecular grid
+
+    /**
+     *  Neighbor list: for each atom, the (distance, index) pairs of all of
+     *  the other atoms sorted by distance (built from Molecule::RIJ)
+     */
+    std::vector<std::vector<std::pair<double,size_t>>> neighbors_;
+
   public:
 
     // Defaulted / Deleted ctors
@@ -491,14 +664,36 @@ namespace ChronusQ {
      *
      *  Constructs a BeckeIntegrator object from a Quadrature scheme for the
      *  radial integration
+     *
+     *  \param [in] scheme Atomic partition scheme
+     *  \param [in] prune  Whether to prune the angular grids (see 
+     *                     angularGrid)
+     *  \param [in] boxBatch Whether to regroup the points into spatially
+     *                     compact batches (see boxGrid)
+     *  \param [in] basisCacheMem Memory (bytes) to cache the basis over the 
+     *                     grid between integrations (0 disables caching)
+     *  \param [in] grid Molecular grid to be (re)used. If not passed (or
+     *  not valid for this integrator) it is built upon integration.
      */ 
     BeckeIntegrator(CQMemManager &mem, Molecule &mol,BasisSet &basis, _QTyp1 g, 
       size_t NAng, size_t NRadPerMacroBatch, SHELL_EVAL_TYPE typ, 
-      double epsScreen) :
+      double epsScreen, PARTITION_SCHEME scheme = BECKE_PARTITION,
+      bool prune = false, bool boxBatch = false, size_t basisCacheMem = 0,
+      std::shared_ptr<MolecularGrid> grid = nullptr) :
       memManager_(mem),molecule_(mol),basisSet_(basis),typ_(typ),
       epsScreen_(epsScreen),
       SphereIntegrator<_QTyp1>(g,NAng,{0.,0.,0.},1.,NRadPerMacroBatch),
-      NDer((typ_ == GRADIENT) ? 4:1){ };
+      NDer((typ_ == GRADIENT) ? 4:1), scheme_(scheme), prune_(prune), 
+      boxBatch_(boxBatch), basisCacheMem_(basisCacheMem), grid_(grid) { 
+
+      if( not grid_ ) grid_ = std::make_shared<MolecularGrid>();
+
+    };
+
+    /**
+     *  \brief Access the molecular grid
+     */ 
+    std::shared_ptr<MolecularGrid> grid() { return grid_; }
 
     /**
      *  Functions for the multicenter numerical integration from
@@ -568,6 +763,122 @@ namespace ChronusQ {
 
     }; // evalPartitionWeights
 
+
+    /**
+     *  Functions for the SSF partitioning from Chem. Phys. Lett. 257, 213
+     *  (1996). The cell function is compactly supported: s(mu) = 1 for
+     *  mu <= -a and s(mu) = 0 for mu >= a.
+     *
+     *  As s(mu_AB) < 1 requires R_AB < 2 r_A / (1-a), only the atoms within
+     *  that distance need be considered for a point (see neighbors_).
+     */
+
+    static constexpr double ssfA = 0.64; ///< SSF cell function parameter
+
+    inline double sSSF(double mu) {
+
+      if( mu <= -ssfA ) return 1.;
+      if( mu >=  ssfA ) return 0.;
+
+      double x  = mu / ssfA;
+      double x2 = x*x;
+      return 0.5 * (1. - x*(35. + x2*(-35. + x2*(21. - 5.*x2))) / 16.); // Eq. 14
+
+    }; // sSSF
+
+    /**
+     *  \brief Evaluates the (unnormalized) SSF cell function of an atom
+     *  for a particular point
+     *
+     *  \param [in] iCen Atomic center
+     *  \param [in] R    Distances of the point to all of the centers
+     */ 
+    double cellSSF(size_t iCen, const double *R) {
+
+      double rA  = R[iCen];
+      double cut = 2. * rA / (1. - ssfA);
+
+      double P = 1.;
+      for(auto &nb : neighbors_[iCen]) {
+        if( nb.first >= cut ) break; // s = 1 beyond
+        P *= sSSF((rA - R[nb.second]) / nb.first);
+        if( P == 0. ) break;
+      }
+
+      return P;
+
+    }; // cellSSF
+
+  /**
+   *  \brief Evaluates the SSF partition weights.
+   *
+   *  Only the neighbors of iCurrent within 2 r / (1-a) of each point 
+   *  contribute to the normalization. Points within 0.5 (1-a) R_nearest
+   *  of iCurrent are entirely owned by it (weight unchanged).
+   *
+   *  \param [in]  iCurrent index for the current atomic center on which the shere is centered
+   *  \param [in]  R Pointer to the distances of all points to the centers
+   *  \param [in/out]  Raw/Updated grid weights
+   *
+   *  \returns  the max weight for the batch. 
+   */  
+    double evalSSFWeights(size_t iCurrent, double *R, 
+      std::vector<double> &batchW) {
+
+      auto &nbA = neighbors_[iCurrent];
+
+      double rInner = nbA.empty() ? std::numeric_limits<double>::infinity() :
+        0.5 * (1. - ssfA) * nbA[0].first;
+
+      size_t nPointsPerBatch = batchW.size();
+
+      double weightMax = 0.0;
+      for(size_t iPt = 0; iPt < nPointsPerBatch; iPt++){ 
+
+        const double *RPt = R + iPt*molecule_.nAtoms;
+        double rA = RPt[iCurrent];
+
+        // Deep inside the cell of iCurrent
+        if( rA < rInner ) {
+          weightMax = std::max(weightMax, batchW[iPt]);
+          continue;
+        }
+
+        double PA = cellSSF(iCurrent,RPt);
+        if( PA == 0. ) { batchW[iPt] = 0.; continue; }
+
+        double sum = PA;
+        double cut = 2. * rA / (1. - ssfA);
+        for(auto &nb : nbA) {
+          if( nb.first >= cut ) break;
+          sum += cellSSF(nb.second,RPt);
+        }
+
+        batchW[iPt] *= PA / sum;
+        weightMax = std::max(weightMax, batchW[iPt]);
+
+      } // loop iPt
+
+      return weightMax;
+
+    }; // evalSSFWeights
+
+    /**
+     *  \brief Builds the sorted atomic neighbor lists (neighbors_)
+     */ 
+    void buildNeighborList() {
+
+      neighbors_.assign(molecule_.nAtoms,{});
+      for(size_t iAtm = 0; iAtm < molecule_.nAtoms; iAtm++) {
+        for(size_t jAtm = 0; jAtm < molecule_.nAtoms; jAtm++)
+          if( iAtm != jAtm ) 
+            neighbors_[iAtm].emplace_back(molecule_.RIJ[iAtm][jAtm],jAtm);
+
+        std::sort(neighbors_[iAtm].begin(),neighbors_[iAtm].end());
+      }
+
+    }; // buildNeighborList
+
   /**
    *  \brief Evaluate the squared distances for all cart_t points in the batchPt 
    *  from all atoms in the molecule and their cartisian compoents.
@@ -603,56 +914,268 @@ namespace ChronusQ {
     }; // calcCenDist
 
   /**
-   *  \brief Integration function according the Becke scheme 
+   *  \brief Radial scaling parameter of an atomic sphere.
    *
-   *  See J. Chem. Phys. 88, 2547(1988).  
+   *  The effective radius is chosen as half of the Bragg-Slater radius of the 
+   *  respective atom (stored in the slaterRadius in Ang), except for
+   *  hydrogen in which case the factor of 0.5 is not applied (the stored value
+   *  for hydrogen is pre scaled by 2 to prevent scaling).
+   *  Procedure according J. Chem. Phys. 88, 2547(1988). pg 2550 
+   */  
+    double radialScale(size_t iAtm) const {
+      return 0.5*molecule_.atoms[iAtm].slaterRadius/AngPerBohr;
+    }; // radialScale
+
+
+    /**
+     *  SG-1 partitioning of the radial coordinate from Chem. Phys. Lett. 
+     *  209, 506 (1993). The boundaries (in units of the atomic radius)
+     *  of the 5 regions for the first three rows (heavier elements use
+     *  the third row boundaries) and the Lebedev orders of each region
+     *  (the fourth region takes the full angular grid).
+     */
+    const std::array<std::array<double,4>,3> sg1Alpha = {{
+      {{ 0.25,   0.5, 1.0, 4.5 }}, // H  - He
+      {{ 0.1667, 0.5, 0.9, 3.5 }}, // Li - Ne
+      {{ 0.1,    0.4, 0.8, 2.5 }}  // Na - 
+    }};
+
+    const std::array<size_t,5> sg1Ang = {{ 6, 38, 86, 0, 86 }};
+
+    /**
+     *  SG-1 atomic radii (Bohr) for H - Ar from Chem. Phys. Lett. 209, 506
+     *  (1993). Heavier elements use the Bragg-Slater radius.
+     */
+    const std::array<double,18> sg1Radii = {{
+      1.0000, 0.5882,                                         // H  - He
+      3.0769, 2.0513, 1.5385, 1.2308, 1.0256, 0.8791, 0.7692, // Li - F
+      0.6838,                                                 // Ne
+      4.0909, 3.1579, 2.5714, 2.1687, 1.8750, 1.6514, 1.4754, // Na - Cl
+      1.3333                                                  // Ar
+    }};
+
+    /**
+     *  \brief Lebedev order of a radial shell of an atomic sphere
+     *
+     *  \param [in] iAtm Atomic center
+     *  \param [in] r    Radius of the shell
+     */  
+    size_t angularOrder(size_t iAtm, double r) const {
+
+      if( not prune_ ) return this->q2.nPts;
+
+      size_t Z   = molecule_.atoms[iAtm].atomicNumber;
+      size_t row = (Z <= 2) ? 0 : (Z <= 10) ? 1 : 2;
+
+      // The stored Bragg-Slater radius of H is pre scaled by 2 (see
+      // radialScale), use the SG-1 radii where they are defined
+      double rRel = (Z >= 1 and Z <= sg1Radii.size()) ? r / sg1Radii[Z-1] :
+        r / (molecule_.atoms[iAtm].slaterRadius/AngPerBohr);
+
+      size_t region = 0;
+      while( region < 4 and rRel > sg1Alpha[row][region] ) region++;
+
+      return (sg1Ang[region] == 0) ? this->q2.nPts : 
+        std::min(sg1Ang[region], this->q2.nPts);
+
+    }; // angularOrder
+
+    /**
+     *  \brief Angular quadrature of a radial shell of an atomic sphere
+     *
+     *  The grids of the pruned regions are generated in buildGrid.
+     */  
+    const Lebedev& angularGrid(size_t iAtm, double r) const {
+
+      size_t nAng = angularOrder(iAtm,r);
+      if( nAng == this->q2.nPts ) return this->q2;
+      return angGrids_.at(nAng);
+
+    }; // angularGrid
+
+
+
+  /**
+   *  \brief Populates the list of significant shells (evalShells), the
+   *  number of significant basis functions (NBE) and the contiguous basis
+   *  function ranges (subMat) of a batch from its evalShell mask.
    *
-   *  \param [in]  res     VXC submatrix for the current batch
-   *  \param [in] func    funtion to be integrated (formVXC)
-   *  \param [in] arg     several arguments to be passed in 
+   *  \returns whether the batch has any significant shell
    */  
-    template <typename T, class F, typename... Args>
-    void integrate(T &res, const F &func, Args... args) {
+    bool setBatchShells(GridBatch &batch) {
 
-#if INT_DEBUG_LEVEL >= 1
-    //TIMING
-      std::chrono::duration<double> durDist(0.)  ;
-      std::chrono::duration<double> durWeight(0.)  ;
-      std::chrono::duration<double> durBasis(0.) ;
-      std::chrono::duration<double> durFunc(0.)  ;
+      batch.NBE = 0;
+      batch.evalShells.clear();
+      batch.subMat.clear();
+
+      for(auto iSh = 0; iSh < basisSet_.nShell; iSh++)
+        if(batch.evalShell[iSh]) {
+          batch.NBE += basisSet_.shells[iSh].size();
+          batch.evalShells.emplace_back(iSh);
+        }
+
+      if(batch.NBE == 0) return false;
+
+      // SubMat Vector of pairs specifing the blocks of the super matrix to be used
+      batch.subMat.emplace_back(
+        basisSet_.mapSh2Bf[batch.evalShells[0]],
+        basisSet_.mapSh2Bf[batch.evalShells[0]] + 
+          basisSet_.shells[batch.evalShells[0]].size()
+      );
+
+      for(auto iShell = batch.evalShells.begin() + 1; 
+          iShell != batch.evalShells.end(); ++iShell) {
+
+        size_t bfSt  = basisSet_.mapSh2Bf[*iShell];
+        size_t bfEnd = bfSt + basisSet_.shells[*iShell].size();
+
+        if(*iShell - *(iShell-1) != 1) batch.subMat.emplace_back(bfSt,bfEnd);
+        else                           batch.subMat.back().second = bfEnd;
+
+      }
+
+      return true;
+
+    }; // setBatchShells
+
+
+  /**
+   *  \brief Regroups the points of the (spherical) batches into spatially
+   *  compact boxes.
+   *
+   *  The points (with non-zero weight) are recursively bisected at the 
+   *  median of the longest dimension of their bounding box (k-d tree) 
+   *  until at most maxBoxSize remain. A shell is significant for a box if
+   *  its cutoff radius reaches the bounding box of the points.
+   *
+   *  \param [in] mapSh2Cut  Cutoff radius of each shell
+   *  \param [in] maxBoxSize Maximum number of points per box
+   */  
+    void boxGrid(const std::vector<double> &mapSh2Cut, size_t maxBoxSize) {
+
+      std::vector<cart_t> pts;
+      std::vector<double> weights;
+      for(auto &batch : grid_->batches)
+      for(auto iPt = 0; iPt < batch.pts.size(); iPt++)
+        if( batch.weights[iPt] != 0. ) {
+          pts.emplace_back(batch.pts[iPt]);
+          weights.emplace_back(batch.weights[iPt]);
+        }
+
+      std::vector<size_t> indx(pts.size());
+      std::iota(indx.begin(),indx.end(),0);
+
+      auto boundingBox = [&](size_t st, size_t end, cart_t &lo, cart_t &hi) {
+        lo = pts[indx[st]]; hi = lo;
+        for(auto i = st + 1; i < end; i++)
+        for(auto k = 0; k < 3; k++) {
+          lo[k] = std::min(lo[k],pts[indx[i]][k]);
+          hi[k] = std::max(hi[k],pts[indx[i]][k]);
+        }
+      };
+
+      // Recursive bisection (depth first to keep the boxes in spatial order)
+      std::vector<std::pair<size_t,size_t>> stack, leaves;
+      if( not pts.empty() ) stack.emplace_back(0,pts.size());
+
+      while( not stack.empty() ) {
+
+        auto range = stack.back(); stack.pop_back();
+        if( range.second - range.first <= maxBoxSize ) {
+          leaves.emplace_back(range); continue;
+        }
+
+        cart_t lo, hi;
+        boundingBox(range.first,range.second,lo,hi);
+
+        size_t dim = 0;
+        for(auto k = 1; k < 3; k++)
+          if( hi[k] - lo[k] > hi[dim] - lo[dim] ) dim = k;
+
+        size_t mid = range.first + (range.second - range.first) / 2;
+        std::nth_element(indx.begin() + range.first, indx.begin() + mid,
+          indx.begin() + range.second,
+          [&](size_t i, size_t j){ return pts[i][dim] < pts[j][dim]; });
+
+        stack.emplace_back(mid,range.second);
+        stack.emplace_back(range.first,mid);
+
+      }
+
+      std::vector<GridBatch> boxes(leaves.size());
+      std::vector<char>      keep(leaves.size(),false);
+
+      #pragma omp parallel for schedule(dynamic)
+      for(size_t iBox = 0; iBox < leaves.size(); iBox++) {
+
+        GridBatch &box = boxes[iBox];
+        size_t st = leaves[iBox].first, end = leaves[iBox].second;
+
+        box.iAtm = 0; // Not meaningful for boxes
+        for(auto i = st; i < end; i++) {
+          box.pts.emplace_back(pts[indx[i]]);
+          box.weights.emplace_back(weights[indx[i]]);
+        }
+
+        cart_t lo, hi;
+        boundingBox(st,end,lo,hi);
+
+        for(auto iSh = 0; iSh < basisSet_.nShell; iSh++) {
+
+#if INT_DEBUG_LEVEL < 3
+          // Distance from the shell center to the box
+          const double *cen = 
+            molecule_.atoms[basisSet_.mapSh2Cen[iSh]].coord.data();
+
+          double dSq = 0.;
+          for(auto k = 0; k < 3; k++) {
+            double d = std::max(0., std::max(lo[k] - cen[k], cen[k] - hi[k]));
+            dSq += d*d;
+          }
+
+          box.evalShell.emplace_back(dSq < mapSh2Cut[iSh]*mapSh2Cut[iSh]);
+#else
+          box.evalShell.emplace_back(true);
 #endif
 
-      size_t nthreads = GetNumThreads();
+        }
 
-      size_t maxBatchSize      = this->nRadPerMacroBatch * this->q2.nPts;
-      size_t maxBatchSizeAtoms = maxBatchSize * molecule_.nAtoms;
+        keep[iBox] = setBatchShells(box);
 
-      // Allocate Basis scratch
-      double *BasisEval = 
-        memManager_.template malloc<double>(nthreads*NDer*maxBatchSize*basisSet_.nBasis);
+      }
 
-      // Allocate Basis scratch (shell cartisian)
-      int LMax = 0;
-      for(auto iSh = 0; iSh < basisSet_.nShell; iSh++)
-        LMax = std::max(basisSet_.shells[iSh].contr[0].l,LMax);
+      grid_->batches.clear();
+      for(size_t iBox = 0; iBox < leaves.size(); iBox++)
+        if( keep[iBox] ) grid_->batches.emplace_back(std::move(boxes[iBox]));
 
-      size_t shSizeCar = ((LMax+1)*(LMax+2))/2; 
-      double * SCR_Car = 
-        memManager_.template malloc<double>(nthreads*NDer*shSizeCar);
+    }; // boxGrid
 
-      // Allocate scratch for Point Distances (squared and components) from each atomic center
 
-      double * cenRSq = memManager_.template malloc<double>(nthreads * maxBatchSizeAtoms);
-      double * cenR   = memManager_.template malloc<double>(nthreads * maxBatchSizeAtoms);
-      double * cenXYZ = memManager_.template malloc<double>(nthreads * 3*maxBatchSizeAtoms);
+  /**
+   *  \brief Build the molecular grid (see MolecularGrid). 
+   *
+   *  Generates the points of the atomic spheres, evaluates the Becke 
+   *  partition weights and the significant shells of each batch, and 
+   *  discards the batches which are screened out. 
+   *
+   *  Depends only on the geometry and the integration parameters, i.e. is 
+   *  only to be called once for a particular grid.
+   */  
+    void buildGrid() {
 
+      size_t nthreads = GetNumThreads();
 
-      // Populate cutoff Map (for each shell the distance beyond which the shell contribution is negligeble
-      std::vector<double> mapSh2Cut;
+      size_t maxBatchSize      = this->nRadPerMacroBatch * this->q2.nPts;
+      size_t maxBatchSizeAtoms = maxBatchSize * molecule_.nAtoms;
+      size_t nBatchPerAtom     = this->q1.nPts / this->nRadPerMacroBatch;
+      size_t nBatch            = nBatchPerAtom * molecule_.nAtoms;
 
       double epsilon = 
         std::max((epsScreen_/maxBatchSizeAtoms),std::numeric_limits<double>::epsilon()); 
 
+      // Populate cutoff Map (for each shell the distance beyond which the shell contribution is negligeble
+      std::vector<double> mapSh2Cut;
+
       // Cutoff radius accordin Eq.20 in J. Chem. Theory Comput. 2011, 7, 3097-3104
       auto cutFunc = [&] (double alpha) -> double{
         return std::sqrt((-std::log(epsilon) + 0.5 * std::log(alpha))/alpha);
@@ -671,61 +1194,57 @@ namespace ChronusQ {
           )
         );
 
+      if( scheme_ == SSF_PARTITION ) buildNeighborList();
 
-      // Function that it is finally integrated
-      auto g = [&](T &res, std::vector<cart_t> &batch, std::vector<double> &weights, 
-        const std::pair<double,double> &rBounds, Args... args) -> void {
+      // Generate the angular grids of the pruned regions
+      angGrids_.clear();
+      if( prune_ )
+      for(auto nAng : sg1Ang)
+        if( nAng != 0 and nAng < this->q2.nPts and not angGrids_.count(nAng) ) {
+          auto it = angGrids_.emplace(nAng,Lebedev(nAng)).first;
+          it->second.generateQuadrature();
+        }
 
-#if INT_DEBUG_LEVEL >= 1
-        // Timing
-        auto topDist = std::chrono::high_resolution_clock::now();
-#endif
+      // Per-thread scratch for the point distances from each atomic center
+      size_t lenArena = 2*CQMemArena::alignedSize<double>(maxBatchSizeAtoms) +
+        CQMemArena::alignedSize<double>(3*maxBatchSizeAtoms);
+      CQThreadArenas arenas(memManager_,lenArena,nthreads);
 
-        size_t thread_id = GetThreadID();       
+      std::vector<GridBatch> batches(nBatch);
+      std::vector<char>      keep(nBatch,false);
 
-        double * BasisEval_loc = BasisEval + thread_id * NDer * maxBatchSize * basisSet_.nBasis;
-        double * SCR_Car_loc   = SCR_Car   + thread_id * NDer * shSizeCar;
+      #pragma omp parallel
+      {
 
-        double * cenRSq_loc = cenRSq + thread_id * maxBatchSizeAtoms;
-        double * cenR_loc   = cenR   + thread_id * maxBatchSizeAtoms;
-        double * cenXYZ_loc = cenXYZ + thread_id * 3*maxBatchSizeAtoms;
+      CQMemArena &arena = arenas[GetThreadID()];
 
-        // Populate for each batch the distances vectors 
-        calcCenDist(batch,cenRSq_loc,cenR_loc,cenXYZ_loc);
+      #pragma omp for schedule(dynamic)
+      for(size_t iBatch = 0; iBatch < nBatch; iBatch++) {
 
+        arena.reset();
+        double * cenRSq = arena.malloc<double>(maxBatchSizeAtoms);
+        double * cenR   = arena.malloc<double>(maxBatchSizeAtoms);
+        double * cenXYZ = arena.malloc<double>(3*maxBatchSizeAtoms);
 
+        GridBatch &batch = batches[iBatch];
+        batch.iAtm = iBatch / nBatchPerAtom;
 
-        double maxR = rBounds.second;
-        double minR = rBounds.first;
+        double scale = radialScale(batch.iAtm);
+        const double *center = molecule_.atoms[batch.iAtm].coord.data();
 
-        double epsilon = 
-          std::max((epsScreen_/maxBatchSizeAtoms),std::numeric_limits<double>::epsilon()); 
+        size_t Jst  = (iBatch % nBatchPerAtom) * this->nRadPerMacroBatch;
+        size_t Jend = Jst + this->nRadPerMacroBatch - 1;
 
-#if INT_DEBUG_LEVEL >= 1
-        // Timing
-        auto botDist = std::chrono::high_resolution_clock::now();
-        durDist += botDist - topDist;
-#endif
-        
+        double minR = scale*this->q1.pts[Jst];
+        double maxR = scale*this->q1.pts[Jend];
 
         // Populating a vector of bool to know which shell need to 
         // be evaluated for the current batch of points according to 
         // the cutoff distances 
-        std::vector<bool> evalShell;
-        size_t basisEvalDim(0);
-        std::vector<size_t> batchEvalShells;
-
-        // SubMat Vector of pairs specifing the blocks of the super matrix to be used
-        std::vector<std::pair<size_t,size_t>> batchSubMat; 
-
-#if INT_DEBUG_LEVEL > 0
-           std::cerr << "Screen ON eps= " << epsilon<<std::endl;
-        
-#endif
         for(auto iSh = 0; iSh < basisSet_.nShell; iSh++) {
 
-          double RAS = molecule_.RIJ[iAtm][basisSet_.mapSh2Cen[iSh]];
-          evalShell.emplace_back(
+          double RAS = molecule_.RIJ[batch.iAtm][basisSet_.mapSh2Cen[iSh]];
+          batch.evalShell.emplace_back(
 #if INT_DEBUG_LEVEL < 3
            // Note. the spherical shell of point has to be within the shell cutoff 
            // if is on the center or inside the other shell cutoff 
@@ -738,136 +1257,249 @@ namespace ChronusQ {
 #endif
           );
 
-          if(evalShell.back()) {
-            basisEvalDim += basisSet_.shells[iSh].size();
-            batchEvalShells.emplace_back(iSh);
-          }
-
         }
- 
-#if INT_DEBUG_LEVEL >= 3
-        std::cerr << "BASIS DIM " << basisEvalDim << std::endl;
-#endif
 
-        // Skyp the entire batch;
-        if(basisEvalDim == 0){ return; }
+        // Skip the entire batch
+        if( not setBatchShells(batch) ) continue;
 
-        //FIXME (Write a function to handle this)
-        batchSubMat.emplace_back(
-          basisSet_.mapSh2Bf[batchEvalShells[0]],
-          basisSet_.mapSh2Bf[batchEvalShells.back()] +
-            basisSet_.shells[batchEvalShells.back()].size()
-        );
+        // Generate the points and the raw weights
+        size_t nPtsBatch = 0;
+        for(size_t J = Jst; J <= Jend; J++) 
+          nPtsBatch += angularOrder(batch.iAtm,scale*this->q1.pts[J]);
 
-        for(auto iShell = batchEvalShells.begin(); 
-            iShell != batchEvalShells.end()-1;
-            ++iShell){
+        batch.pts.resize(nPtsBatch);
+        batch.weights.resize(nPtsBatch);
 
-          if(*(iShell+1) - (*iShell) != 1){
-            batchSubMat.back().second = 
-              basisSet_.mapSh2Bf[*iShell] + basisSet_.shells[*iShell].size();
+        size_t iPt = 0;
+        for(size_t J = Jst; J <= Jend; J++) {
+          double R = this->q1.pts[J] * scale; 
+          const Lebedev &ang = angularGrid(batch.iAtm,R);
+        for(size_t i = 0; i < ang.nPts; i++, iPt++) {
 
-            batchSubMat.emplace_back(
-              basisSet_.mapSh2Bf[*(iShell+1)],
-              basisSet_.mapSh2Bf[batchEvalShells.back()] +
-                basisSet_.shells[batchEvalShells.back()].size()
-            );
-          }
-       
-        }
+          // INT = W1(i) * W2(j) * R(i) * R(i) * 
+          //       func(R(i)*x(j),R(i)*y(j),R(i)*z(j))
+          batch.pts[iPt][0] = R*ang.pts[i][0] + center[0];
+          batch.pts[iPt][1] = R*ang.pts[i][1] + center[1];
+          batch.pts[iPt][2] = R*ang.pts[i][2] + center[2];
+          batch.weights[iPt] = 
+            this->q1.weights[J] * ang.weights[i] * R * R * scale; 
 
-        if(batchEvalShells.size() == 1) 
-          batchSubMat[0].second = 
-            batchSubMat[0].first + basisSet_.shells[batchEvalShells[0]].size();
+        } // i loop
+        } // J loop
 
-#if INT_DEBUG_LEVEL >= 1
-        // TIMING
-        auto topBasis = std::chrono::high_resolution_clock::now();
-#endif
-        
-        evalShellSet(typ_,basisSet_.shells,evalShell,cenRSq_loc,cenXYZ_loc,batch.size(),molecule_.nAtoms,
-          basisSet_.mapSh2Cen,basisEvalDim,BasisEval_loc,SCR_Car_loc,shSizeCar,basisSet_.forceCart);
+        // Modify weight according Becke scheme, get max weight
+        calcCenDist(batch.pts,cenRSq,cenR,cenXYZ);
+        auto maxWeight = (scheme_ == SSF_PARTITION) ?
+          evalSSFWeights(batch.iAtm,cenR,batch.weights) :
+          evalPartitionWeights(batch.iAtm,cenR,batch.weights); 
 
-#if INT_DEBUG_LEVEL >= 1
-        // TIMNG
-        auto botBasis = std::chrono::high_resolution_clock::now();
-        durBasis += botBasis - topBasis;
+#if INT_DEBUG_LEVEL < 3
+        if (std::abs(maxWeight) < epsilon) continue; // Batch screened
 #endif
-        
+
+        keep[iBatch] = true;
+
+      } // loop over batches
+
+      } // OpenMP context
+
+      // Keep the significant batches (in order)
+      grid_->clearBasisCache(NDer);
+      grid_->batches.clear();
+      for(size_t iBatch = 0; iBatch < nBatch; iBatch++)
+        if( keep[iBatch] ) grid_->batches.emplace_back(std::move(batches[iBatch]));
+
+      // Regroup into spatially compact batches
+      if( boxBatch_ ) boxGrid(mapSh2Cut,maxBatchSize);
+
+      grid_->makeSchedule();
+
+      grid_->setKey(molecule_,this->q1.nPts,this->q2.nPts,
+        this->nRadPerMacroBatch,epsScreen_,scheme_,prune_,boxBatch_);
+
+    }; // buildGrid
+
+
+  /**
+   *  \brief Builds the molecular grid if it is not valid for the current
+   *  geometry and integration parameters.
+   */  
+    void prepareGrid() {
+
+      if( not grid_->isValid(molecule_,this->q1.nPts,this->q2.nPts,
+                this->nRadPerMacroBatch,epsScreen_,scheme_,prune_,boxBatch_) ) 
+        buildGrid();
+
+    }; // prepareGrid
+
+
+  /**
+   *  \brief Integration function according the Becke scheme 
+   *
+   *  See J. Chem. Phys. 88, 2547(1988).  
+   *
+   *  The molecular grid is built on the first call (or whenever the 
+   *  geometry or the integration parameters change), subsequent calls only 
+   *  evaluate the basis over the stored batches.
+   *
+   *  \param [in]  res     VXC submatrix for the current batch
+   *  \param [in] func    funtion to be integrated (formVXC)
+   *  \param [in] arg     several arguments to be passed in 
+   */  
+    template <typename T, class F, typename... Args>
+    void integrate(T &res, const F &func, Args... args) {
+
 #if INT_DEBUG_LEVEL >= 1
-        // Timing
-        auto topWeight = std::chrono::high_resolution_clock::now();
+    //TIMING
+      std::chrono::duration<double> durGrid(0.)  ;
+      std::chrono::duration<double> durBasis(0.) ;
+      std::chrono::duration<double> durFunc(0.)  ;
+
+      auto topGrid = std::chrono::high_resolution_clock::now();
 #endif
 
-        // Modify weight according Becke scheme, get max weight
-        auto maxWeight = evalPartitionWeights(iAtm,cenR_loc,weights); 
+      prepareGrid();
+
+      // The cached basis is only valid for the same derivative order
+      if( grid_->basisCacheNDer != NDer or basisCacheMem_ == 0 ) 
+        grid_->clearBasisCache(NDer);
+
+      if( basisCacheMem_ > 0 ) grid_->basisCacheMemManager = &memManager_;
 
 #if INT_DEBUG_LEVEL >= 1
-        // Timing
-        auto botWeight = std::chrono::high_resolution_clock::now();
-        durWeight += botWeight - topWeight;
+      durGrid = std::chrono::high_resolution_clock::now() - topGrid;
 #endif
 
-#if INT_DEBUG_LEVEL < 3
-         if (std::abs(maxWeight) < epsilon) {
-           //std::cerr << "batch screened" << std::endl;
-           return;
-         }
-#endif
+      size_t nthreads = GetNumThreads();
 
+      size_t maxBatchSize      = this->nRadPerMacroBatch * this->q2.nPts;
+      size_t maxBatchSizeAtoms = maxBatchSize * molecule_.nAtoms;
+
+      // Allocate Basis scratch (shell cartisian)
+      int LMax = 0;
+      for(auto iSh = 0; iSh < basisSet_.nShell; iSh++)
+        LMax = std::max(basisSet_.shells[iSh].contr[0].l,LMax);
+
+      size_t shSizeCar = ((LMax+1)*(LMax+2))/2; 
+
+      // Per-thread scratch arenas for the basis evaluation and the point 
+      // distances (squared and components) from each atomic center
+      size_t lenArena = 
+        CQMemArena::alignedSize<double>(NDer*maxBatchSize*basisSet_.nBasis) +
+        CQMemArena::alignedSize<double>(NDer*shSizeCar) +
+        2*CQMemArena::alignedSize<double>(maxBatchSizeAtoms) + 
+        CQMemArena::alignedSize<double>(3*maxBatchSizeAtoms);
+
+      CQThreadArenas arenas(memManager_,lenArena,nthreads);
+
+      #pragma omp parallel
+      {
+
+      CQMemArena &arena = arenas[GetThreadID()];
+
+      // Thread local result (reduced below)
+      T resLoc(0.);
+
+      // Batches are dispatched most expensive first
+      #pragma omp for schedule(dynamic,1)
+      for(size_t iTask = 0; iTask < grid_->schedule.size(); iTask++) {
+
+        GridBatch &batch = grid_->batches[grid_->schedule[iTask]];
 
 #if INT_DEBUG_LEVEL >= 1
-        auto topFunc = std::chrono::high_resolution_clock::now();
+        // TIMING
+        auto topBasis = std::chrono::high_resolution_clock::now();
 #endif
 
+        // Release the scratch of the previous batch
+        arena.reset();
+
+        size_t lenBasis = NDer * batch.pts.size() * batch.NBE;
+        double * BasisEval = nullptr;
+
+        // Replay the cached basis
+        if( batch.basisEval and batch.lenBasisEval == lenBasis ) 
+          BasisEval = batch.basisEval;
+
+        else {
+
+          BasisEval = 
+            arena.malloc<double>(NDer * maxBatchSize * basisSet_.nBasis);
+          double * SCR_Car   = arena.malloc<double>(NDer * shSizeCar);
+
+          double * cenRSq = arena.malloc<double>(maxBatchSizeAtoms);
+          double * cenR   = arena.malloc<double>(maxBatchSizeAtoms);
+          double * cenXYZ = arena.malloc<double>(3*maxBatchSizeAtoms);
 
+          // Populate for each batch the distances vectors 
+          calcCenDist(batch.pts,cenRSq,cenR,cenXYZ);
+          
+          evalShellSet(typ_,basisSet_.shells,batch.evalShell,cenRSq,cenXYZ,
+            batch.pts.size(),molecule_.nAtoms,basisSet_.mapSh2Cen,batch.NBE,
+            BasisEval,SCR_Car,shSizeCar,basisSet_.forceCart);
+
+          // Cache the basis if it fits in the budget
+          if( basisCacheMem_ > 0 ) {
+
+            size_t cached;
+            #pragma omp atomic capture
+            cached = grid_->basisCacheBytes += lenBasis * sizeof(double);
+
+            if( cached <= basisCacheMem_ ) {
+
+              // The memory manager is not thread safe
+              #pragma omp critical
+              {
+                CQMemTag memTag(memManager_,"BASISCACHE");
+                batch.basisEval = memManager_.malloc<double>(lenBasis);
+              }
+
+              std::copy_n(BasisEval,lenBasis,batch.basisEval);
+              batch.lenBasisEval = lenBasis;
+
+            } else {
+              #pragma omp atomic
+              grid_->basisCacheBytes -= lenBasis * sizeof(double);
+            }
+
+          }
+
+        }
+
+#if INT_DEBUG_LEVEL >= 1
+        // TIMNG
+        auto botBasis = std::chrono::high_resolution_clock::now();
+        durBasis += botBasis - topBasis;
+#endif
+        
         // Final call to be resambled ba the lambda function
-        func(res,batch,weights,basisEvalDim,BasisEval_loc,batchEvalShells,batchSubMat,args...);
+        func(resLoc,batch.pts,batch.weights,batch.NBE,BasisEval,
+          batch.evalShells,batch.subMat,args...);
 
 #if INT_DEBUG_LEVEL >= 1
         auto botFunc = std::chrono::high_resolution_clock::now();
         // TIMNG
-        durFunc += botFunc - topFunc;
+        durFunc += botFunc - botBasis;
 #endif
         
-      }; // End g function
+      } // loop over batches
 
-      // Perform integration over atomic centers, by using spherical Integrators
-      for(iAtm = 0; iAtm < molecule_.nAtoms; iAtm++) {
+      #pragma omp critical
+      res += resLoc;
 
-        this->Center = {molecule_.atoms[iAtm].coord[0],
-                        molecule_.atoms[iAtm].coord[1],
-                        molecule_.atoms[iAtm].coord[2]};
+      } // OpenMP context
 
-        // The effective radius is chosen as half of the Bragg-Slater radius of the 
-        // respective atom (stored in the slaterRadius in Ang), except for
-        // hydrogen in which case the factor of 0.5 is not applied (the stored value
-        // for hydrogen is pre scaled by 2 to prevent scaling).
-        // Procedure according J. Chem. Phys. 88, 2547(1988). pg 2550 
-          
-        this->Scale = 0.5*molecule_.atoms[iAtm].slaterRadius/AngPerBohr;
-        SphereIntegrator<_QTyp1>::template integrate<T>(1.,res,g,args...);
-
-      } // loop over atoms
       res *= 4.* M_PI;
 
-      // clean memory
-      memManager_.free(BasisEval,cenRSq,cenXYZ,cenR,SCR_Car);
-
 #if INT_DEBUG_LEVEL >= 1
       //TIMING
-      double d_batch =  molecule_.nAtoms *  this->q1.nPts /  this->nRadPerMacroBatch;
+      double d_batch =  grid_->batches.size();
       std::cerr << std::scientific << std::endl;
       std::cerr << "Total # of Batch  " << d_batch << std::endl;
-      std::cerr << "Total Dist " << durDist.count() << std::endl;
-      std::cerr << "Total Weight " << durWeight.count() << std::endl;
+      std::cerr << "Total Grid " << durGrid.count() << std::endl;
       std::cerr << "Total Basis " << durBasis.count() << std::endl;
       std::cerr << "Total Func " << durFunc.count() << std::endl;
-      std::cerr << "Total int the gfun " <<  durDist.count()+ durBasis.count() +durFunc.count() 
-                << std::endl;
 
-      std::cerr << "Dist " << durDist.count()/d_batch << std::endl;
-      std::cerr << "Weight " << durWeight.count()/d_batch << std::endl;
       std::cerr << "Basis " << durBasis.count()/d_batch << std::endl;
       std::cerr << "Func " << durFunc.count()/d_batch << std::endl;
 #endif
@@ -27,22 +27,59 @@
 #include <chronusq_sys.hpp>
 #include <boost/pool/simple_segregated_storage.hpp>
 
+#include <cstdlib>
+#include <cstring>
+#ifdef __linux__
+  #include <sys/mman.h>
+#endif
+
 //#define MEM_PRINT
 
+// Alignment of the memory partition and of the arena allocations
+#define CQ_MEM_ALIGN       64
+#define CQ_HUGEPAGE_ALIGN  2097152 // 2 MB
+
 namespace ChronusQ {
 
   typedef boost::simple_segregated_storage<size_t> mem_backend;
 
+  /**
+   *  The CQMemBlock struct. Record of an allocated memory block
+   */
+  struct CQMemBlock {
+    size_t nBytes;  ///< Requested size (bytes)
+    size_t nBlocks; ///< Number of segregation blocks
+    size_t tag;     ///< Index of the allocation tag
+  }; // struct CQMemBlock
+
+  /**
+   *  The CQMemTagStats struct. Allocation accounting for an allocation
+   *  tag (e.g. "ERI", "VXC", "DIIS", "RT")
+   */
+  struct CQMemTagStats {
+    std::string name;   ///< Tag name
+    size_t      cur;    ///< Currently allocated (bytes)
+    size_t      peak;   ///< Peak allocation (bytes)
+    size_t      nAlloc; ///< Number of allocations
+  }; // struct CQMemTagStats
+
   class CQMemManager : public mem_backend {
 
     size_t N_;            ///< Total bytes to be allocated
     size_t NAlloc_;       ///< Number of blocks currently allocated
     size_t BlockSize_;    ///< Segregation block size
-    std::vector<char> V_; ///< Internal memort
+    char   *V_;           ///< Internal memory
+    bool   hugePages_;    ///< Whether to back V_ with (2 MB) hugepages
 
-    std::unordered_map<void*,std::pair<size_t,size_t>> AllocatedBlocks_;
+    std::unordered_map<void*,CQMemBlock> AllocatedBlocks_;
       ///< Map from block pointer to the size of the block
 
+    size_t NAllocPeak_;   ///< High-water mark (blocks)
+    bool   printAllocs_;  ///< Print every malloc / free to std::cerr
+
+    std::vector<CQMemTagStats> tags_;     ///< Per-tag accounting
+    std::vector<size_t>        tagStack_; ///< Stack of active tags
+
     bool isAllocated_;
 
     /**
@@ -80,14 +117,25 @@ namespace ChronusQ {
      *
      *  \param [in] N          Total memory (in bytes) to be allocated
      *  \param [in] BlockSize  Segregation block size
+     *  \param [in] hugePages  Whether to back the partition with 2 MB
+     *                         (transparent) hugepages
      *
      */ 
-     CQMemManager(size_t N = 0, size_t BlockSize = 2048) :
-       mem_backend(), N_(N), BlockSize_(BlockSize), isAllocated_(false),
-       NAlloc_(0) {
+     CQMemManager(size_t N = 0, size_t BlockSize = 2048, 
+       bool hugePages = false) :
+       mem_backend(), N_(N), NAlloc_(0), BlockSize_(BlockSize), 
+       V_(nullptr), hugePages_(hugePages), NAllocPeak_(0),
+       tags_(1,{"MISC",0,0,0}), isAllocated_(false) {
+#ifdef MEM_PRINT
+       printAllocs_ = true;
+#else
+       printAllocs_ = false;
+#endif
        if( N_ and BlockSize_ ) allocMem();
      };
 
+     ~CQMemManager() { if( V_ != nullptr ) std::free(V_); }
+
      /**
       *  Allocates the memory block
       */ 
@@ -95,16 +143,38 @@ namespace ChronusQ {
        assert(not isAllocated_);
 
        fixBlockNumber(); // fix buffer length
-       V_.resize(N_);    // allocate the memory
+
+       // allocate the memory
+       size_t align = hugePages_ ? CQ_HUGEPAGE_ALIGN : CQ_MEM_ALIGN;
+       void *ptr = nullptr;
+       if( posix_memalign(&ptr,align,N_) ) {
+         std::bad_alloc excp;
+         throw excp;
+       }
+       V_ = static_cast<char*>(ptr);
+
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+       // Request transparent hugepages to reduce TLB misses on the
+       // partition (silently falls back to regular pages)
+       if( hugePages_ ) madvise(V_,N_,MADV_HUGEPAGE);
+#endif
+
+       // Zero the partition (as the std::vector<char> storage did). The
+       // blocks are touched in parallel such that the pages are spread
+       // (first touch) over the threads which use them
+       const size_t nBlocks = N_ / BlockSize_;
+       #pragma omp parallel for schedule(static)
+       for(size_t iBlock = 0; iBlock < nBlocks; iBlock++)
+         std::memset(V_ + iBlock*BlockSize_,0,BlockSize_);
 
        // segregate (uses functionality from boost::simple_segregated_storage
-       this->add_ordered_block(&V_.front(),V_.size(),BlockSize_);
+       this->add_ordered_block(V_,N_,BlockSize_);
 
        isAllocated_ = true; // ensure no additional allocs can be made
 
        #ifdef MEM_PRINT
          std::cerr << "Creating Memory Partition of " << N_
-                   << " bytes starting at " << (int*) &V_.front() 
+                   << " bytes starting at " << (int*) V_ 
                    << std::endl;
        #endif
      };
@@ -128,35 +198,35 @@ namespace ChronusQ {
       
        // Check to see if requested memory would overflow allocated
        // memory. Throw a bad alloc if so
-       if( (NAlloc_ + nBlocks) * BlockSize_ > N_ ) {
-         std::bad_alloc excp;
-         throw excp;
-       }
-
-       // Update the number of allocated blocks
-       NAlloc_ += nBlocks; 
+       if( (NAlloc_ + nBlocks) * BlockSize_ > N_ ) 
+         outOfMemory(n * sizeof(T));
 
-       #ifdef MEM_PRINT
+       if( printAllocs_ )
          std::cerr << "Allocating " << n << " words of " << typeid(T).name()
-                   << " data (" << nBlocks << " blocks): ";
-       #endif
+                   << " data (" << nBlocks << " blocks) [" 
+                   << tags_[currentTag()].name << "]: ";
 
        // Get a pointer from boost::simple_segregated_storage
        void * ptr = mem_backend::malloc_n(nBlocks,BlockSize_);
 
        // Throw an error if boost returned a NULL pointer (many
-       // possible causes)
-       if(ptr == NULL) {
-         std::bad_alloc excp;
-         throw excp;
-       }
+       // possible causes, most likely fragmentation)
+       if(ptr == NULL) outOfMemory(n * sizeof(T));
 
-       #ifdef MEM_PRINT
-         std::cerr << "  PTR = " << ptr << std::endl;
-       #endif
+       if( printAllocs_ ) std::cerr << "  PTR = " << ptr << std::endl;
+
+       // Update the number of allocated blocks and the high-water mark
+       NAlloc_ += nBlocks; 
+       NAllocPeak_ = std::max(NAllocPeak_,NAlloc_);
 
        // Keep a record of the block
-       AllocatedBlocks_[ptr] = { n * sizeof(T), nBlocks }; 
+       size_t tag = currentTag();
+       AllocatedBlocks_[ptr] = { n * sizeof(T), nBlocks, tag }; 
+
+       // Per-tag accounting
+       tags_[tag].cur += nBlocks * BlockSize_;
+       tags_[tag].peak = std::max(tags_[tag].peak,tags_[tag].cur);
+       tags_[tag].nAlloc++;
 
        return static_cast<T*>(ptr); // Return the pointer
      }; // CQMemManager::malloc
@@ -182,16 +252,16 @@ namespace ChronusQ {
        // blocks
        assert( it != AllocatedBlocks_.end() );
 
-       #ifdef MEM_PRINT
-         std::cerr << "Freeing " << it->second 
+       if( printAllocs_ )
+         std::cerr << "Freeing " << it->second.nBlocks
                    << " blocks of data starting from " 
                    << static_cast<void*>(ptr) << std::endl;
-       #endif
 
-       NAlloc_ -= it->second.second; // deduct block size from allocated memory
+       NAlloc_ -= it->second.nBlocks; // deduct block size from allocated memory
+       tags_[it->second.tag].cur -= it->second.nBlocks * BlockSize_;
   
        // deallocate the memory in an ordered fashion
-       mem_backend::ordered_free_n(ptr,it->second.second,BlockSize_);
+       mem_backend::ordered_free_n(ptr,it->second.nBlocks,BlockSize_);
 
        // Remove pointer from allocated list
        AllocatedBlocks_.erase(it);
@@ -238,12 +308,158 @@ namespace ChronusQ {
        // blocks
        assert( it != AllocatedBlocks_.end() );
 
-       return std::floor(it->second.first / sizeof(T));
+       return std::floor(it->second.nBytes / sizeof(T));
      }; // CQMemManager::getSize
 
 
 
 
+     /**
+      *  \brief Index of the tag to which allocations are currently charged
+      */ 
+     size_t currentTag() const {
+       return tagStack_.empty() ? 0 : tagStack_.back();
+     };
+
+     /**
+      *  \brief Charge subsequent allocations to a tag (see CQMemTag). 
+      *  Tags nest, allocations are charged to the innermost tag only.
+      *
+      *  \param [in] tag Name of the tag
+      */ 
+     void pushTag(const std::string &tag) {
+
+       auto it = std::find_if(tags_.begin(),tags_.end(),
+         [&](const CQMemTagStats &x){ return x.name == tag; });
+
+       if( it == tags_.end() ) {
+         tags_.push_back({tag,0,0,0});
+         it = tags_.end() - 1;
+       }
+
+       tagStack_.push_back(std::distance(tags_.begin(),it));
+
+     }; // CQMemManager::pushTag
+
+     /**
+      *  \brief Pop the innermost allocation tag
+      */ 
+     void popTag() { if( not tagStack_.empty() ) tagStack_.pop_back(); }
+
+     /**
+      *  \brief Turn the printing of every malloc / free on / off
+      */ 
+     void setPrintAllocs(bool print) { printAllocs_ = print; }
+
+
+     // Getters for the accounting
+     size_t totalMemory()   const { return N_; }
+     size_t inUse()         const { return NAlloc_ * BlockSize_; }
+     size_t highWaterMark() const { return NAllocPeak_ * BlockSize_; }
+     const std::vector<CQMemTagStats>& tagStats() const { return tags_; }
+
+
+     /**
+      *  \brief Largest contiguous free run (bytes) in the partition.
+      *
+      *  Walks the (ordered) free list of the segregated storage.
+      */ 
+     size_t largestFreeRun() const {
+
+       size_t maxRun = 0, run = 0;
+       for( void *chunk = this->first; chunk != nullptr; 
+            chunk = nextof(chunk) ) {
+
+         run++;
+         void *next = nextof(chunk);
+         if( next != static_cast<char*>(chunk) + BlockSize_ ) {
+           maxRun = std::max(maxRun,run);
+           run = 0;
+         }
+
+       }
+
+       return maxRun * BlockSize_;
+
+     }; // CQMemManager::largestFreeRun
+
+     /**
+      *  \brief Fragmentation of the free memory: 
+      *  1 - (largest contiguous free run) / (total free memory).
+      *
+      *  0 means that any request which fits in the free memory can be
+      *  served, values close to 1 mean that large requests will fail
+      *  even though enough memory is free.
+      */ 
+     double fragmentation() const {
+       size_t nFree = N_ - NAlloc_ * BlockSize_;
+       if( nFree == 0 ) return 0.;
+       return 1. - double(largestFreeRun()) / double(nFree);
+     }; // CQMemManager::fragmentation
+
+
+     /**
+      *  Prints the memory usage report (high-water mark, fragmentation and
+      *  per-tag accounting) to a specified output device.
+      *
+      *  \param [in] out Output device to print the report
+      */ 
+     void printReport(std::ostream &out) const {
+
+       std::ios_base::fmtflags flags(out.flags());
+       std::streamsize prec = out.precision();
+
+       out << "  Memory Usage Report:\n\n" << std::left << std::fixed;
+
+       out << "    " << std::setw(28) << "Total Memory:" 
+           << std::setprecision(2) << N_ / 1e6 << " MB\n";
+       out << "    " << std::setw(28) << "High-Water Mark:" 
+           << std::setprecision(2) << highWaterMark() / 1e6 << " MB (" 
+           << std::setprecision(1) << 100. * highWaterMark() / N_ << "%)\n";
+       out << "    " << std::setw(28) << "Currently Allocated:" 
+           << std::setprecision(2) << inUse() / 1e6 << " MB\n";
+       out << "    " << std::setw(28) << "Fragmentation:"
+           << std::setprecision(3) << fragmentation() << "\n\n";
+
+       out << "    " << std::setw(12) << "Tag" << std::right
+           << std::setw(16) << "Peak (MB)" 
+           << std::setw(16) << "Current (MB)" 
+           << std::setw(14) << "Allocations" << "\n";
+
+       for( auto &tag : tags_ ) {
+         if( not tag.nAlloc ) continue;
+         out << "    " << std::left << std::setw(12) << tag.name 
+             << std::right << std::setprecision(2)
+             << std::setw(16) << tag.peak / 1e6 
+             << std::setw(16) << tag.cur / 1e6 
+             << std::setw(14) << tag.nAlloc << "\n";
+       }
+
+       out << std::endl;
+
+       out.flags(flags); out.precision(prec);
+
+     }; // CQMemManager::printReport
+
+     /**
+      *  \brief Report the state of the allocator to std::cerr and throw a
+      *  std::bad_alloc
+      *
+      *  \param [in] nBytes Size of the failed request
+      */ 
+     void outOfMemory(size_t nBytes) const {
+
+       std::cerr << "CQMemManager: Unable to allocate " << nBytes 
+                 << " B [" << tags_[currentTag()].name << "]\n\n";
+       printReport(std::cerr);
+
+       std::bad_alloc excp;
+       throw excp;
+
+     }; // CQMemManager::outOfMemory
+
+
+
      /**
       *  Prints the CQMemManager allocation table to a specified output
       *  device.
@@ -254,10 +470,11 @@ namespace ChronusQ {
        out << "Allocation Table (unordered):\n\n";
        out << std::left;
        out << std::setw(15) << "Pointer" << std::setw(15) << "Size (Bytes)" 
-           << std::endl;
+           << std::setw(15) << "Tag" << std::endl;
        for( auto &block : AllocatedBlocks_ )
          out << std::setw(15) << static_cast<void*>(block.first) 
-             << std::setw(15) <<  BlockSize_*block.second.second 
+             << std::setw(15) <<  BlockSize_*block.second.nBlocks 
+             << std::setw(15) <<  tags_[block.second.tag].name
              << std::endl;
 
      }; // CQMemManager::printAllocTable
@@ -282,6 +499,11 @@ namespace ChronusQ {
 
       out << std::endl;
 
+      out << std::setw(30) << "Hugepages: ";
+      out << (mem.hugePages_ ? "On" : "Off");
+
+      out << std::endl;
+
       out << std::setw(30) << "Block Size: ";
       out << std::setw(15) << mem.BlockSize_ << " B"; 
       out << " (" << mem.N_ / mem.BlockSize_ << " Blocks)";
@@ -294,6 +516,12 @@ namespace ChronusQ {
 
       out << std::endl;
 
+      out << std::setw(30) << "High-Water Mark: ";
+      out << std::setw(15) << mem.NAllocPeak_*mem.BlockSize_ << " B"; 
+      out << " (" << mem.NAllocPeak_ << " Blocks)";
+
+      out << std::endl;
+
       out << std::setw(30) << "Free Memory: ";
       out << std::setw(15) << mem.N_ - mem.NAlloc_*mem.BlockSize_ << " B"; 
       out << " (" << mem.N_ / mem.BlockSize_ - mem.NAlloc_ << " Blocks)";
@@ -310,6 +538,225 @@ namespace ChronusQ {
 
   }; // class CQMemManager
 
+
+
+  /**
+   *  The CQMemTag class. Charges the allocations of a CQMemManager to a
+   *  tag for the lifetime of the object.
+   *
+   *  z.B.
+   *
+   *  {
+   *    CQMemTag tag(memManager,"ERI");
+   *    double *ERI = memManager.malloc<double>(n); // Charged to "ERI"
+   *  }
+   */
+  class CQMemTag {
+
+    CQMemManager &mem_; ///< Tagged memory manager
+
+    public:
+
+    CQMemTag(const CQMemTag &)            = delete;
+    CQMemTag& operator=(const CQMemTag &) = delete;
+
+    CQMemTag(CQMemManager &mem, const std::string &tag) : mem_(mem) {
+      mem_.pushTag(tag);
+    };
+
+    ~CQMemTag() { mem_.popTag(); }
+
+  }; // class CQMemTag
+
+
+
+
+  /**
+   *  The CQMemArena class. A bump (stack) allocator for scoped scratch
+   *  space which exposes the same malloc / free API as CQMemManager.
+   *
+   *  The arena reserves a single block from a CQMemManager on construction
+   *  (and returns it on destruction). Allocations are served by advancing
+   *  an offset into this block, and frees in (or out of) LIFO order rewind
+   *  it, so neither malloc nor free perform any lookup in the common case.
+   *
+   *  z.B.
+   *
+   *  CQMemArena arena(memManager,nBytes);
+   *  double *X = arena.malloc<double>(n);
+   *  ...
+   *  arena.free(X);
+   */
+  class CQMemArena {
+
+    CQMemManager *mem_;   ///< Parent memory manager
+    char         *V_;     ///< Arena storage (owned by mem_)
+    size_t        N_;     ///< Size of the arena (bytes)
+    size_t        top_;   ///< Current offset of the top of the stack
+    size_t        high_;  ///< High-water mark (bytes)
+
+    std::vector<std::pair<size_t,bool>> stack_; 
+      ///< Offsets of the live (true) / freed (false) allocations
+
+    public:
+
+    // Disable copy construction and assignment
+    CQMemArena(const CQMemArena &)            = delete;
+    CQMemArena& operator=(const CQMemArena &) = delete;
+
+    /**
+     *  \brief Constructor.
+     *
+     *  \param [in] mem  Memory manager from which to reserve the arena
+     *  \param [in] N    Size of the arena (bytes)
+     */ 
+    CQMemArena(CQMemManager &mem, size_t N) : mem_(&mem), V_(nullptr), 
+      N_(N), top_(0), high_(0) {
+      if( N_ ) V_ = mem_->malloc<char>(N_);
+    };
+
+    CQMemArena(CQMemArena &&other) : mem_(other.mem_), V_(other.V_), 
+      N_(other.N_), top_(other.top_), high_(other.high_), 
+      stack_(std::move(other.stack_)) {
+      other.V_ = nullptr;
+    };
+
+    ~CQMemArena() { if( V_ != nullptr ) mem_->free(V_); }
+
+
+    /**
+     *  \brief Size (bytes) of an arena allocation of n items of type T,
+     *  to be used in sizing the arena.
+     */ 
+    template <typename T>
+    static size_t alignedSize(size_t n) {
+      return ((n * sizeof(T) + CQ_MEM_ALIGN - 1) / CQ_MEM_ALIGN) * 
+        CQ_MEM_ALIGN;
+    };
+
+    /**
+     *  \brief Allocates a contiguous block of memory of a specified
+     *  type from the top of the arena.
+     *
+     *  \param [in] n  Number of items of type T to allocate
+     *  \return        Pointer to contiguous memory block that contains
+     *                 n items of type T
+     */ 
+    template <typename T>
+    T* malloc(size_t n) {
+
+      size_t nBytes = alignedSize<T>(n);
+
+      if( top_ + nBytes > N_ ) {
+        std::bad_alloc excp;
+        throw excp;
+      }
+
+      T* ptr = reinterpret_cast<T*>(V_ + top_);
+
+      stack_.emplace_back(top_,true);
+      top_ += nBytes;
+      high_ = std::max(high_,top_);
+
+      return ptr;
+
+    }; // CQMemArena::malloc
+
+
+    /**
+     *  Frees a contiguous memory block given a pointer previously
+     *  returned by CQMemArena::malloc. The top of the arena is rewound
+     *  past all of the freed blocks at the top of the stack.
+     *
+     *  \param [in] ptr Pointer to free 
+     */ 
+    template <typename T>
+    void free( T* &ptr ) {
+
+      size_t off = reinterpret_cast<char*>(ptr) - V_;
+
+      // Most frees are LIFO, search from the top
+      auto it = std::find_if(stack_.rbegin(),stack_.rend(),
+        [&](const std::pair<size_t,bool> &x){ return x.first == off; });
+
+      assert( it != stack_.rend() and it->second );
+
+      it->second = false;
+      while( not stack_.empty() and not stack_.back().second ) {
+        top_ = stack_.back().first;
+        stack_.pop_back();
+      }
+
+      ptr = NULL; // NULL out the pointer
+
+    }; // CQMemArena::free
+
+    /**
+     *  Parameter pack of CQMemArena::free (see CQMemManager::free)
+     */ 
+    template <typename T, typename... Targs>
+    void free( T* &ptr, Targs... args) {
+      free(ptr); free(args...);
+    }; // CQMemArena::free (parameter pack)
+
+
+    /**
+     *  Releases all of the allocations in the arena
+     */ 
+    void reset() { top_ = 0; stack_.clear(); }
+
+    size_t size()      const { return N_;    }
+    size_t inUse()     const { return top_;  }
+    size_t highWater() const { return high_; }
+
+  }; // class CQMemArena
+
+
+
+  /**
+   *  The CQThreadArenas class. A set of per-thread CQMemArena's to serve
+   *  the scratch allocations within OpenMP regions without any
+   *  synchronization.
+   *
+   *  Each thread's arena is only touched by that thread, so on NUMA
+   *  systems its pages are mapped local to the thread (first touch).
+   *
+   *  z.B.
+   *
+   *  CQThreadArenas arenas(memManager,nBytesPerThread,GetNumThreads());
+   *  #pragma omp parallel
+   *  {
+   *    double *SCR = arenas[GetThreadID()].malloc<double>(n);
+   *    ...
+   *  }
+   */
+  class CQThreadArenas {
+
+    std::vector<CQMemArena> arenas_; ///< Per-thread arenas
+
+    public:
+
+    /**
+     *  \brief Constructor.
+     *
+     *  \param [in] mem      Memory manager from which to reserve the arenas
+     *  \param [in] N        Size of each arena (bytes)
+     *  \param [in] nThreads Number of arenas (threads)
+     */ 
+    CQThreadArenas(CQMemManager &mem, size_t N, size_t nThreads) {
+      arenas_.reserve(nThreads);
+      for(size_t i = 0; i < nThreads; i++) arenas_.emplace_back(mem,N);
+    };
+
+    /**
+     *  \brief Access the arena of a particular thread
+     */ 
+    CQMemArena& operator[](size_t i) { return arenas_[i]; }
+
+    size_t size() const { return arenas_.size(); }
+
+  }; // class CQThreadArenas
+
 }; // namespace ChronusQ
 
 #endif
@@ -48,6 +48,8 @@ namespace ChronusQ {
   template <template <typename> class _SSTyp, typename T>
   void RealTime<_SSTyp,T>::doPropagation() {
 
+    CQMemTag memTag(memManager_,"RT");
+
     printRTHeader();
 
     bool Start(false); // Start the MMUT iterations
@@ -92,6 +92,17 @@ namespace ChronusQ {
     oper_t_coll2 diisFock;    ///< List of AO Fock matrices for DIIS extrap
     oper_t_coll2 diisOnePDM;  ///< List of AO Density matrices for DIIS extrap
     oper_t_coll2 diisError;   ///< List of orthonormal [F,D] for DIIS extrap
+    std::vector<double> diisEnergy; ///< List of energies for EDIIS extrap
+    std::vector<T>      diisB;      ///< Persistent DIIS B matrix (nKeep)
+
+    // Stores the L-BFGS history for the second-order SCF
+    std::vector<T*>     soscfStep;  ///< Previous orbital rotation steps
+    std::vector<T*>     soscfDGrad; ///< Previous changes in orbital gradient
+    std::vector<double> soscfRho;   ///< 1 / Re<y,s> of the correction pairs
+    T* soscfPrevGrad = nullptr;     ///< Orbital gradient of the previous step
+
+    // Scratch for the density matrix purification (see purifyOrthoFock)
+    T* purifySCR = nullptr;
 
 
     // Method specific propery storage
@@ -203,7 +214,8 @@ namespace ChronusQ {
     void getNewOrbitals(EMPerturbation &, bool frmFock = true);
 
     // Misc procedural
-    void diagOrthoFock();
+    void diagOrthoFock(bool partial = false);
+    bool purifyOrthoFock();
     void FDCommutator(oper_t_coll &);
     virtual void saveCurrentState();
     virtual void formDelta();
@@ -225,6 +237,15 @@ namespace ChronusQ {
     void modifyFock();
     void fockDamping();
     void scfDIIS(size_t);
+    bool energyDIIS(size_t, std::vector<T>&);
+
+    // Second-order SCF functions (see include/singleslater/soscf.hpp for docs)
+    void allocSOSCFStorage();
+    void deallocSOSCFStorage();
+    size_t nOrbRot();
+    void orbitalGradient(T*, double*);
+    void rotateOrbitals(T*);
+    bool soscfOrbitals();
 
   }; // class SingleSlater
 
@@ -26,6 +26,8 @@
 
 #include <chronusq_sys.hpp>
 #include <wavefunction/base.hpp>
+#include <cqlinalg/matfunc.hpp>
+#include <cqlinalg/eig.hpp>
 
 #include <fields.hpp>
 #include <util/files.hpp>
@@ -36,6 +38,8 @@ namespace ChronusQ {
     CDIIS,      ///< Commutator DIIS
     EDIIS,      ///< Energy DIIS
     CEDIIS,     ///< Commutator & Energy DIIS
+    ADIIS,      ///< Augmented Roothaan-Hall energy DIIS
+    CADIIS,     ///< Commutator & Augmented Roothaan-Hall energy DIIS
     NONE = -1  
   };
 
@@ -71,6 +75,8 @@ namespace ChronusQ {
     // DIIS settings 
     DIIS_ALG diisAlg = CDIIS; ///< Type of DIIS extrapolation 
     size_t nKeep     = 10;    ///< Number of matrices to use for DIIS
+    double diisSwitchTol = 1e-1; ///< |[F,D]| below which CEDIIS / CADIIS
+                                 ///< switch to CDIIS
 
     // Static Damping settings
     bool   doDamp         = true;           ///< Flag for turning on damping
@@ -80,7 +86,29 @@ namespace ChronusQ {
 
     // Incremental Fock build settings
     bool   doIncFock = true; ///< Whether to perform an incremental fock build
-    size_t nIncFock  = 20;   ///< Restart incremental fock build after n steps
+    size_t nIncFock  = 20;   ///< Max incremental builds between full builds
+    double incFockScale    = 1e-3; ///< Screening thresh = scale * |dP(S)|
+    double incFockResetTol = 1.;   ///< Full build once the accumulated error
+                                   ///< exceeds incFockResetTol * |dP(S)|
+
+    // Density update settings
+    bool   doPurify      = false; ///< Purify instead of diagonalizing the Fock
+    PURIFICATION_ALG purifyAlg = TRS4_PURIFICATION; ///< Purification scheme
+    double purifyTol     = 1e-12; ///< Tr[P - P**2] convergence tolerance
+    size_t maxPurifyIter = 100;   ///< Maximum purification iterations
+
+    // Eigensolver settings
+    HERMETIAN_EIGEN_ALG eigAlg = QR_EIGEN; ///< Fock diagonalization backend
+    int nEigVirt = -1; ///< Virtual orbitals obtained during the SCF 
+                       ///< iterations (partial spectrum), < 0 -> all
+
+    // Second-order (quasi-Newton) SCF settings
+    bool   doSOSCF       = false; ///< L-BFGS orbital rotations in lieu of
+                                  ///< diagonalization near convergence
+    double soscfStartTol = 1e-2;  ///< Orbital gradient norm below which
+                                  ///< the L-BFGS steps are taken
+    double soscfMaxStep  = 0.5;   ///< Maximum orbital rotation angle
+    size_t soscfNKeep    = 10;    ///< Number of L-BFGS correction pairs
 
     // Misc control
     size_t maxSCFIter = 128; ///< Maximum SCF iterations.
@@ -100,7 +128,21 @@ namespace ChronusQ {
     double RMSDenMag;    ///< RMS change in magnetization (X,Y,Z) density
     double nrmFDC;       ///< 2-Norm of [F,D]
 
-    size_t nSCFIter = 0; ///< Number of SCF Iterations
+    size_t nSCFIter  = 0; ///< Number of SCF Iterations
+    size_t nDIISIter = 0; ///< Number of entries saved to the DIIS history
+
+    // Second-order SCF status
+    double nrmOrbGrad = 0.; ///< 2-Norm of the orbital gradient
+    size_t nSOSCFIter = 0;  ///< Consecutive L-BFGS orbital rotation steps
+
+    // Incremental Fock build status
+    double incFockThresh = 0.; ///< Screening threshold of the last build
+    double incFockError  = 0.; ///< Accumulated error since last full build
+    size_t nIncFockIter  = 0;  ///< Incremental builds since last full build
+    bool   incFockBuild  = false; ///< Whether the last build was incremental
+
+    size_t nQuartetScreened = 0; ///< Screened ERI quartets (last build)
+    size_t nQuartetTotal    = 0; ///< Examined ERI quartets (last build)
 
   }; // SCFConvergence struct
 
@@ -43,7 +43,12 @@ namespace ChronusQ {
     // Initialize type independent parameters
     bool isConverged = false;
     scfControls.dampParam = scfControls.dampStartParam;
+
+    // Only the DIRECT contraction screens on the change in the density,
+    // an incremental build is no cheaper than a full build otherwise
     scfControls.doIncFock = scfControls.doIncFock and (aoints.cAlg == DIRECT);
+    scfConv.incFockError  = 0.;
+    scfConv.nIncFockIter  = 0;
 
     if( printLevel > 0 ) printSCFHeader(std::cout,pert);
 
@@ -132,9 +137,17 @@ namespace ChronusQ {
 
       if (scfControls.diisAlg != NONE) {
         out << std::setw(38) << std::left << "  DIIS Extrapolation Algorithm:";
-        if (scfControls.diisAlg == CDIIS) out << "CDIIS";
+        if (scfControls.diisAlg == CDIIS)  out << "CDIIS";
+        if (scfControls.diisAlg == EDIIS)  out << "EDIIS";
+        if (scfControls.diisAlg == ADIIS)  out << "ADIIS";
+        if (scfControls.diisAlg == CEDIIS) out << "EDIIS + CDIIS";
+        if (scfControls.diisAlg == CADIIS) out << "ADIIS + CDIIS";
         out << std::endl;
 
+        if (scfControls.diisAlg == CEDIIS or scfControls.diisAlg == CADIIS)
+          out << std::left << "    * Switching to CDIIS once |[F,D]| < "
+              << scfControls.diisSwitchTol << std::endl;
+
         out << std::left << "    * DIIS will track up to " 
             << scfControls.nKeep << " previous iterations" << std::endl;
       }
@@ -145,10 +158,39 @@ namespace ChronusQ {
     }
 
 
+    if( scfControls.eigAlg != QR_EIGEN ) {
+      out << "\n  * Will Diagonalize the Fock Matrix using ";
+      if( scfControls.eigAlg == DC_EIGEN ) out << "Divide and Conquer\n";
+      else                                 out << "MRRR\n";
+    }
+
+    if( scfControls.nEigVirt >= 0 )
+      out << "\n  * Will Only Obtain " << scfControls.nEigVirt 
+          << " Virtual Orbitals During the SCF Iterations\n";
+
+    if( scfControls.doPurify ) {
+      out << "\n  * Will Obtain the Density by ";
+      if( scfControls.purifyAlg == TRS4_PURIFICATION ) out << "TRS4";
+      else                                            out << "Canonical";
+      out << " Purification\n";
+      out << "    * Purification Tolerance = " << scfControls.purifyTol 
+          << "\n";
+    }
+
+    if( scfControls.doSOSCF ) {
+      out << "\n  * Will Perform Quasi-Newton (L-BFGS) Orbital Rotations "
+          << "Once |G(orb)| < " << scfControls.soscfStartTol << "\n";
+      out << "    * Maximum Rotation = " << scfControls.soscfMaxStep 
+          << "\n";
+    }
+
     if( scfControls.doIncFock ) {
-      out << "\n  * Will Perform Incremental Fock Build -- Restarting Every "
-          << scfControls.nIncFock << " SCF Steps\n";
-         
+      out << "\n  * Will Perform Incremental Fock Build -- Restarting After "
+          << "at most " << scfControls.nIncFock << " SCF Steps\n";
+      out << "    * Screening Threshold = " << scfControls.incFockScale
+          << " * |\u0394P(S)|\n";
+      out << "    * Restarting when the Accumulated Screening Error Exceeds "
+          << scfControls.incFockResetTol << " * |\u0394P(S)|\n";
     }
 
     // Field print
@@ -192,6 +234,8 @@ namespace ChronusQ {
     out << std::setw(18) << " |\u0394P(S)|";
     if(not iCS or nC > 1)
       out << std::setw(18) << "  |\u0394P(M)|";
+    if( scfControls.doIncFock )
+      out << std::setw(18) << "  Screened";
      
     out << std::endl;
     out << std::setw(16) << "-------------";
@@ -200,6 +244,8 @@ namespace ChronusQ {
     out << std::setw(18) << "-------";
     if(not iCS or nC > 1)
       out << std::setw(18) << "-------";
+    if( scfControls.doIncFock )
+      out << std::setw(18) << "  --------";
     out << std::endl;
 
   }; // SingleSlater<T>::printSCFHeader
@@ -227,6 +273,14 @@ namespace ChronusQ {
       out << "   ";
       out << std::setw(13) << std::right << scfConv.RMSDenMag;
     }
+
+    // Number of shell quartets screened in the Fock build
+    // (I = incremental, F = full)
+    if( scfControls.doIncFock ) {
+      out << "   ";
+      out << std::setw(11) << std::right << scfConv.nQuartetScreened
+          << " (" << (scfConv.incFockBuild ? "I" : "F") << ")";
+    }
   
     out << std::endl;
   }; // SingleSlater<T>::printSCFProg
@@ -28,6 +28,7 @@
 #include <singleslater.hpp>
 #include <util/matout.hpp>
 #include <cqlinalg/blas1.hpp>
+#include <cqlinalg/blas3.hpp>
 
 namespace ChronusQ {
 
@@ -44,10 +45,8 @@ namespace ChronusQ {
     // DIIS extrapolation
     if (scfControls.diisAlg == NONE) return;
 
-    if (scfControls.diisAlg == CDIIS) {
-      size_t nExtrap = std::min(scfConv.nSCFIter+1,scfControls.nKeep);
-      scfDIIS(nExtrap);
-    } else CErr("Only CDIIS is implemented so far",std::cout);
+    size_t nExtrap = std::min(scfConv.nDIISIter+1,scfControls.nKeep);
+    scfDIIS(nExtrap);
 
   }; // SingleSlater<T>::modifyFock
 
@@ -105,9 +104,13 @@ namespace ChronusQ {
   template <typename T>
   void SingleSlater<T>::scfDIIS(size_t nExtrap) {
 
+    CQMemTag memTag(this->memManager,"DIIS");
+
     // Save the current AO Fock and density matrices
+    // The history is indexed by the saved entries rather than the SCF
+    // iterations, which skip the DIIS on orbital rotation (SOSCF) steps
     size_t NB    = aoints.basisSet().nBasis;
-    size_t iDIIS = scfConv.nSCFIter % scfControls.nKeep;
+    size_t iDIIS = scfConv.nDIISIter % scfControls.nKeep;
     for(auto i = 0; i < this->fock.size(); i++) {
       std::copy_n(this->fock[i],NB*NB,diisFock[iDIIS][i]);
       std::copy_n(this->onePDM[i],NB*NB,diisOnePDM[iDIIS][i]);
@@ -120,25 +123,78 @@ namespace ChronusQ {
     for(auto &E : diisError[iDIIS])
       scfConv.nrmFDC = std::max(scfConv.nrmFDC,TwoNorm<double>(NB*NB,E,1));
 
-    // Just save the Fock, density, and commutator for the first iteration
-    if (scfConv.nSCFIter == 0) return;
+    // Update the row / column of the persistent B matrix for the new error
+    // (B(k,j) = <E(k),E(j)>, k <= j, summed over the spin components)
+    size_t nKeep = scfControls.nKeep;
+    std::vector<T> BRow(nExtrap,0.);
+    for(auto i = 0; i < diisError[iDIIS].size(); i++) {
+
+      // <E(j),E(iDIIS)>, j <= iDIIS
+      Gemm('C','N',iDIIS+1,1,NB*NB,T(1.),diisError[0][i],NB*NB,
+        diisError[iDIIS][i],NB*NB,T(1.),&BRow[0],iDIIS+1);
+
+      // <E(iDIIS),E(j)>, j > iDIIS
+      if( nExtrap > iDIIS + 1 )
+        Gemm('C','N',1,nExtrap-iDIIS-1,NB*NB,T(1.),diisError[iDIIS][i],NB*NB,
+          diisError[iDIIS+1][i],NB*NB,T(1.),&BRow[iDIIS+1],1);
+
+    }
+
+    for(auto j = 0; j < nExtrap; j++) {
+      diisB[j + iDIIS*nKeep] = BRow[j];
+      diisB[iDIIS + j*nKeep] = BRow[j];
+    }
+
+    // Save the energy of the current density for EDIIS. The Fock matrix
+    // is that of the current density at this point, the energy is 
+    // restored such that the SCF energy convergence is unaffected
+    DIIS_ALG alg = scfControls.diisAlg;
+    if( alg == EDIIS or alg == CEDIIS ) {
+
+      double OBEnergy = this->OBEnergy, MBEnergy = this->MBEnergy;
+      double totalEnergy = this->totalEnergy;
+
+      this->computeEnergy();
+      diisEnergy[iDIIS] = this->totalEnergy;
+
+      this->OBEnergy    = OBEnergy;
+      this->MBEnergy    = MBEnergy;
+      this->totalEnergy = totalEnergy;
+
+    }
+
+    // Just save the Fock, density, and commutator for the first entry
+    if (scfConv.nDIISIter++ == 0) return;
+
+    // Energy based DIIS far from convergence, CDIIS otherwise
+    bool useEnergy = alg == EDIIS or alg == ADIIS or
+      ((alg == CEDIIS or alg == CADIIS) and 
+       scfConv.nrmFDC > scfControls.diisSwitchTol);
+
+    std::vector<T> coeffs;
+    bool extrapSuccess;
+
+    if( useEnergy ) extrapSuccess = energyDIIS(nExtrap,coeffs);
+    else {
       
-    // Build the B matrix and return the coefficients for the extrapolation
-    size_t nMat = fockOrtho.size();
-    DIIS<T> extrap(nExtrap,nMat,NB*NB,diisError);
+      // Solve for the coefficients for the extrapolation using the 
+      // persistent B matrix
+      DIIS<T> extrap(nExtrap,&diisB[0],nKeep);
+
+      extrapSuccess = extrap.extrapolate();
+      coeffs = extrap.coeffs;
 
+    }
 
-    if(extrap.extrapolate()) { 
+
+    if(extrapSuccess) { 
       // Extrapolate Fock and density matrices using DIIS coefficients
+      //   F = [F(0) F(1) ...] * c (single pass over the history)
       for(auto i = 0; i < fockOrtho.size(); i++) {
-        std::fill_n(fock[i],NB*NB,0.);
-        std::fill_n(this->onePDM[i],NB*NB,0.);
-        for(auto j = 0; j < nExtrap; j++) {
-          MatAdd('N','N', NB, NB, T(1.), fock[i], NB, T(extrap.coeffs[j]), 
-            diisFock[j][i], NB, fock[i], NB);
-          MatAdd('N','N', NB, NB, T(1.), this->onePDM[i], NB, 
-            T(extrap.coeffs[j]), diisOnePDM[j][i], NB, this->onePDM[i], NB);
-        } 
+        Gemm('N','N',NB*NB,1,nExtrap,T(1.),diisFock[0][i],NB*NB,
+          &coeffs[0],nExtrap,T(0.),fock[i],NB*NB);
+        Gemm('N','N',NB*NB,1,nExtrap,T(1.),diisOnePDM[0][i],NB*NB,
+          &coeffs[0],nExtrap,T(0.),this->onePDM[i],NB*NB);
       }
     } else {
       std::cout << "\n    *** WARNING: DIIS Inversion Failed -- "
@@ -152,6 +208,91 @@ namespace ChronusQ {
 
 
 
+
+ /**
+   *  \brief Energy based DIIS (EDIIS / ADIIS)
+   *
+   *  Obtains the coefficients of the convex combination (c >= 0, 
+   *  sum c = 1) of the saved AO Fock and density matrices which minimizes 
+   *  a quadratic model of the energy. In terms of the traces 
+   *  <F(i),D(j)> = Tr[F(i) D(j)] summed over the spin components
+   *  (E = 0.5 Tr[h D(S)] + 0.25 sum_k Tr[G(k) D(k)]),
+   *
+   *  EDIIS (K. N. Kudin, G. E. Scuseria and E. Cances, J. Chem. Phys. 
+   *    116, 8255 (2002)):
+   *
+   *    E(c) = sum_i c_i E(i) 
+   *         - 1/8 sum_ij c_i c_j <F(i) - F(j),D(i) - D(j)>
+   *
+   *  ADIIS (X. Hu and W. Yang, J. Chem. Phys. 132, 054109 (2010)), 
+   *  expanded about the most recent iteration n:
+   *
+   *    E(c) = E(n) + 1/2 sum_i c_i <F(n),D(i) - D(n)>
+   *         + 1/4 sum_ij c_i c_j <F(j) - F(n),D(i) - D(n)>
+   *
+   *  \param [in]  nExtrap Size of the extrapolation space
+   *  \param [out] coeffs  Extrapolation coefficients
+   *
+   *  \returns Whether the extrapolation was successful
+   */ 
+  template <typename T>
+  bool SingleSlater<T>::energyDIIS(size_t nExtrap, std::vector<T> &coeffs) {
+
+    size_t NB    = aoints.basisSet().nBasis;
+    size_t iDIIS = (scfConv.nDIISIter - 1) % scfControls.nKeep;
+    bool   doEDIIS = scfControls.diisAlg == EDIIS or 
+                     scfControls.diisAlg == CEDIIS;
+
+    // FD(i,j) = <F(i),D(j)>
+    std::vector<double> FD(nExtrap*nExtrap,0.);
+    for(auto i = 0; i < nExtrap; i++)
+    for(auto j = 0; j < nExtrap; j++)
+    for(auto k = 0; k < this->fock.size(); k++)
+      FD[i + j*nExtrap] += InnerProd<double>(NB*NB,diisFock[i][k],1,
+        diisOnePDM[j][k],1);
+
+    // Quadratic model, f(c) = g**T c + 0.5 * c**T H c
+    std::vector<double> g(nExtrap), H(nExtrap*nExtrap), c(nExtrap,0.);
+    if( doEDIIS ) {
+
+      for(auto i = 0; i < nExtrap; i++) {
+        g[i] = diisEnergy[i];
+        for(auto j = 0; j < nExtrap; j++)
+          H[i + j*nExtrap] = -0.25 * (FD[i + i*nExtrap] + FD[j + j*nExtrap] -
+            FD[i + j*nExtrap] - FD[j + i*nExtrap]);
+      }
+
+      // Start from the lowest energy
+      c[std::min_element(g.begin(),g.end()) - g.begin()] = 1.;
+
+    } else {
+
+      const size_t n = iDIIS;
+      for(auto i = 0; i < nExtrap; i++) {
+        g[i] = 0.5 * (FD[n + i*nExtrap] - FD[n + n*nExtrap]);
+        for(auto j = 0; j < nExtrap; j++)
+          H[i + j*nExtrap] = 0.25 * (
+            FD[j + i*nExtrap] - FD[j + n*nExtrap] - FD[n + i*nExtrap] + 
+            FD[i + j*nExtrap] - FD[i + n*nExtrap] - FD[n + j*nExtrap] +
+            2. * FD[n + n*nExtrap]);
+      }
+
+      // Start from the most recent iteration
+      c[n] = 1.;
+
+    }
+
+    SimplexQuadMin(nExtrap,&g[0],&H[0],&c[0]);
+
+    coeffs.assign(c.begin(),c.end());
+
+    return std::all_of(c.begin(),c.end(),
+      [](double x){ return std::isfinite(x); });
+
+  }; // SingleSlater<T>::energyDIIS
+
+
+
  /**
    *  \brief Allocates storage for different extrapolation approaches to SCF 
    *  
@@ -162,25 +303,38 @@ namespace ChronusQ {
     diisFock.clear();
     diisOnePDM.clear();
     diisError.clear();
+    diisEnergy.clear();
     prevFock.clear();
 
     size_t FSize = memManager.template getSize(fock[SCALAR]);
 
     // Allocate memory to store previous orthonormal Focks and densities for DIIS
+    //   The history of each spin component is stored contiguously
+    //   (NB*NB x nKeep) such that the extrapolation is a single GEMV 
     if (scfControls.diisAlg != NONE) {
-      for(auto i = 0; i < scfControls.nKeep; i++) {
-        diisFock.emplace_back();
-        diisOnePDM.emplace_back();
-        diisError.emplace_back();
-        for(auto j = 0; j < this->fock.size(); j++) {
-          diisFock[i].emplace_back(memManager.template malloc<T>(FSize));
-          diisOnePDM[i].emplace_back(memManager.template malloc<T>(FSize));
-          diisError[i].emplace_back(memManager.template malloc<T>(FSize));
-          std::fill_n(diisFock[i][j],FSize,0.);
-          std::fill_n(diisOnePDM[i][j],FSize,0.);
-          std::fill_n(diisError[i][j],FSize,0.);
+      size_t nKeep = scfControls.nKeep;
+      size_t HSize = aoints.basisSet().nBasis * aoints.basisSet().nBasis;
+
+      diisFock.resize(nKeep);
+      diisOnePDM.resize(nKeep);
+      diisError.resize(nKeep);
+
+      for(auto j = 0; j < this->fock.size(); j++) {
+        T* FHist = memManager.template malloc<T>(HSize*nKeep);
+        T* DHist = memManager.template malloc<T>(HSize*nKeep);
+        T* EHist = memManager.template malloc<T>(HSize*nKeep);
+        std::fill_n(FHist,HSize*nKeep,0.);
+        std::fill_n(DHist,HSize*nKeep,0.);
+        std::fill_n(EHist,HSize*nKeep,0.);
+
+        for(auto i = 0; i < nKeep; i++) {
+          diisFock[i].emplace_back(FHist + i*HSize);
+          diisOnePDM[i].emplace_back(DHist + i*HSize);
+          diisError[i].emplace_back(EHist + i*HSize);
         } 
       }
+      diisEnergy.assign(nKeep,0.);
+      diisB.assign(nKeep*nKeep,0.);
     }
 
     // Allocate memory to store previous orthonormal Fock for damping 
@@ -201,12 +355,10 @@ namespace ChronusQ {
 
     // Deallocate memory to store previous orthonormal Focks and densities for DIIS
     if (scfControls.diisAlg != NONE) {
-      for(auto i = 0; i < scfControls.nKeep; i++) {
-        for(auto j = 0; j < this->fock.size(); j++) {
-          memManager.free(diisFock[i][j]);
-          memManager.free(diisOnePDM[i][j]);
-          memManager.free(diisError[i][j]);
-        } 
+      for(auto j = 0; j < this->fock.size(); j++) {
+        memManager.free(diisFock[0][j]);
+        memManager.free(diisOnePDM[0][j]);
+        memManager.free(diisError[0][j]);
       }
     }
 
@@ -165,6 +165,7 @@ namespace ChronusQ {
 #include <singleslater/guess.hpp>   // Guess header
 #include <singleslater/scf.hpp>     // SCF header
 #include <singleslater/extrap.hpp>  // Extrapolate header
+#include <singleslater/soscf.hpp>   // Second-order SCF header
 #include <singleslater/print.hpp>   // Print header
 #include <singleslater/pop.hpp>     // Population analysis
 
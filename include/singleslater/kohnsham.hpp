@@ -29,6 +29,9 @@
 #include <basisset/basisset_util.hpp>
 #include <cqlinalg/blasext.hpp>
 #include <dft.hpp>
+#include <grid/integrator.hpp>
+
+#include <mutex>
 
 // KS_DEBUG_LEVEL == 1 - Timing
 #ifndef KS_DEBUG_LEVEL
@@ -48,9 +51,26 @@ namespace ChronusQ {
     size_t nAng         = 302;   ///< # Angular points
     size_t nRad         = 100;   ///< # Radial points
     size_t nRadPerBatch = 4;     ///< # Radial points / macro batch
+    PARTITION_SCHEME scheme = BECKE_PARTITION; ///< Atomic partition scheme
+    bool prune          = false; ///< SG-1 style pruning of the angular grids
+    bool boxBatch       = false; ///< Spatially compact (k-d tree) batches
+    size_t basisCacheMem = 0;    ///< Memory (bytes) to cache the basis on the grid
+    double rhoThresh    = 0.;    ///< Density below which the XC kernel is skipped
   };
 
 
+  /**
+   *  \brief A trial density and the storage for the XC kernel 
+   *  (fxc) contracted with it.
+   *
+   *  Only the real, symmetric part of the trial density contributes.
+   */ 
+  struct XCKernelContraction {
+    std::vector<double*> X;  ///< Trial density (SCALAR, MZ)
+    std::vector<double*> AX; ///< Storage for fxc * X (SCALAR, MZ)
+  }; // struct XCKernelContraction
+
+
   /**
    *  \breif The Kohn--Sham class.
    *
@@ -73,6 +93,8 @@ namespace ChronusQ {
     std::vector<std::shared_ptr<DFTFunctional>> functionals; ///< XC kernels
     IntegrationParam intParam; ///< Numerical integration controls
 
+    std::shared_ptr<MolecularGrid> molGrid; ///< Molecular grid (built on demand)
+
     bool isGGA_; ///< Whether or not the XC kernel is within the GGA
     double XCEnergy; ///< Exchange-correlation energy
 
@@ -208,9 +230,15 @@ namespace ChronusQ {
     }; // computeEnergy
 
     // KS specific functions
-    // See include/singleslater/kohnsham/vxc.hpp for docs.
+    // See include/singleslater/kohnsham/vxc.hpp and 
+    // include/singleslater/kohnsham/fxc.hpp for docs.
 
     void formVXC(); 
+    void contractFXC(std::vector<XCKernelContraction> &cont);
+
+    void incXCBatch(double *X, const double *SCR, size_t NBE,
+      const std::vector<size_t> &batchEvalShells, 
+      const std::vector<size_t> &batchBf, std::vector<std::mutex> &colLocks);
 
     void evalDen(SHELL_EVAL_TYPE typ, size_t NPts,size_t NBE, size_t NB, 
       std::vector<std::pair<size_t,size_t>> &subMatCut, double *SCR1,
@@ -240,7 +268,25 @@ namespace ChronusQ {
       bool* Msmall, double *nColl, double *gammaColl );
 
     void loadVXCder(size_t NPts, double *Den, double *sigma, double *EpsEval, double*VRhoEval, 
-      double *VsigmaEval, double *EpsSCR, double *VRhoSCR, double *VsigmaSCR); 
+      double *VsigmaEval, double *EpsSCR, double *VRhoSCR, double *VsigmaSCR,
+      double *DenSCR, double *sigmaSCR, size_t *PtMap); 
+
+    void loadFXCder(size_t NPts, double *Den, double *sigma, double *VsigmaEval,
+      double *V2RhoEval, double *V2RhoSigmaEval, double *V2SigmaEval, 
+      double *SCR);
+
+    /**
+     *  \brief Density below which the XC kernel is not evaluated. 
+     *
+     *  Never smaller than the smallest threshold of the functionals 
+     *  (below which LibXC returns zeros).
+     */ 
+    double denThreshold() {
+      double thresh = std::numeric_limits<double>::infinity();
+      for(auto &f : functionals) thresh = std::min(thresh,f->densityThreshold());
+      if( functionals.size() == 0 ) thresh = 0.;
+      return std::max(thresh,intParam.rhoThresh);
+    }
 
     void constructZVars(DENSITY_TYPE denTyp, bool isGGA, size_t NPts, 
       double *VrhoEval, double *VsigmaEval, double *ZrhoVar1, 
@@ -0,0 +1,463 @@
+/*
+ *  This file is part of the Chronus Quantum (ChronusQ) software package
+ *
+ *  Copyright (C) 2014-2017 Li Research Group (University of Washington)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ *  Contact the Developers:
+ *    E-Mail: xsli@uw.edu
+ *
+ */
+#ifndef __INCLUDED_SINGLESLATER_KOHNSHAM_FXC_HPP__
+#define __INCLUDED_SINGLESLATER_KOHNSHAM_FXC_HPP__
+
+#include <singleslater/kohnsham.hpp>
+
+#include <grid/integrator.hpp>
+#include <basisset/basisset_util.hpp>
+#include <cqlinalg/blasext.hpp>
+
+namespace ChronusQ {
+
+  /**
+   *  \brief wrapper for evaluating and loading the second derivatives of
+   *  the DFT kernel (fxc) from libxc wrt to the U var, summed over all of
+   *  the functionals.
+   *
+   *  \param [in]  NPts           Number of points in the batch
+   *  \param [in]  Den            Pointer to the Uvar Density vector[+,-].
+   *  \param [in]  Gamma          Pointer to the GGA Uvar vector[++,+-,--].
+   *
+   *  \param [out] VgammaEval     Pointer to the first part der of the energy
+   *                              per unit volume in terms of the
+   *                              gammas[++,+-,--] (GGA only).
+   *
+   *  \param [out] V2RhoEval      Pointer to the second part der of the
+   *                              energy per unit volume in terms of the
+   *                              dens[++,+-,--].
+   *
+   *  \param [out] V2RhoGammaEval Pointer to the second part der of the
+   *                              energy per unit volume in terms of the
+   *                              dens and gammas (6 per point, GGA only).
+   *
+   *  \param [out] V2GammaEval    Pointer to the second part der of the
+   *                              energy per unit volume in terms of the
+   *                              gammas (6 per point, GGA only).
+   *
+   *  \param [in]  SCR            Scratch space (21 * NPts).
+   *
+   *  See include/dft.hpp for the ordering of the derivatives.
+   */
+  template <typename T>
+  void KohnSham<T>::loadFXCder(size_t NPts, double *Den, double *Gamma,
+    double *VgammaEval, double *V2RhoEval, double *V2RhoGammaEval,
+    double *V2GammaEval, double *SCR) {
+
+    bool anyGGA = std::any_of(functionals.begin(),functionals.end(),
+                   [](std::shared_ptr<DFTFunctional> &x) {return x->isGGA(); });
+
+    std::fill_n(V2RhoEval,3*NPts,0.);
+    if( anyGGA ) {
+      std::fill_n(VgammaEval,3*NPts,0.);
+      std::fill_n(V2RhoGammaEval,6*NPts,0.);
+      std::fill_n(V2GammaEval,6*NPts,0.);
+    }
+
+    double *EpsSCR        = SCR;
+    double *VRhoSCR       = EpsSCR        + NPts;
+    double *VgammaSCR     = VRhoSCR       + 2*NPts;
+    double *V2RhoSCR      = VgammaSCR     + 3*NPts;
+    double *V2RhoGammaSCR = V2RhoSCR      + 3*NPts;
+    double *V2GammaSCR    = V2RhoGammaSCR + 6*NPts;
+
+    for(auto iF = 0; iF < functionals.size(); iF++) {
+
+      if( functionals[iF]->isGGA() ) {
+
+        functionals[iF]->evalEXC_VXC(NPts,Den,Gamma,EpsSCR,VRhoSCR,VgammaSCR);
+        functionals[iF]->evalFXC(NPts,Den,Gamma,V2RhoSCR,V2RhoGammaSCR,
+          V2GammaSCR);
+
+        DaxPy(3*NPts,1.,VgammaSCR,1,VgammaEval,1);
+        DaxPy(6*NPts,1.,V2RhoGammaSCR,1,V2RhoGammaEval,1);
+        DaxPy(6*NPts,1.,V2GammaSCR,1,V2GammaEval,1);
+
+      } else
+        functionals[iF]->evalFXC(NPts,Den,V2RhoSCR);
+
+      DaxPy(3*NPts,1.,V2RhoSCR,1,V2RhoEval,1);
+
+    }
+
+    // Kernel is zero below the density threshold (see loadVXCder)
+    double thresh = denThreshold();
+    for(auto iPt = 0ul; iPt < NPts; iPt++)
+      if( Den[2*iPt] + Den[2*iPt+1] < thresh ) {
+        std::fill_n(V2RhoEval + 3*iPt,3,0.);
+        if( anyGGA ) {
+          std::fill_n(VgammaEval     + 3*iPt,3,0.);
+          std::fill_n(V2RhoGammaEval + 6*iPt,6,0.);
+          std::fill_n(V2GammaEval    + 6*iPt,6,0.);
+        }
+      }
+
+  }; // KohnSham<T>::loadFXCder
+
+
+
+
+  /**
+   *  \brief Contract the XC kernel (fxc) with a set of trial densities.
+   *
+   *  For each trial density D' (SCALAR, MZ) evaluates the first order
+   *  change of VXC wrt D'
+   *
+   *    K[D']_{mu nu} = \int d^3r (dv_rho  phi_mu phi_nu +
+   *                               dW . Del (phi_mu phi_nu))
+   *
+   *  where dv_rho and dW are the linear responses of the LDA and GGA
+   *  potentials at the current (ground state) density, i.e. there
+   *  is no nonlinear VXC evaluation per trial density. The results follow
+   *  the conventions of VXC (SCALAR = + + -, MZ = + - -). The molecular
+   *  grid, batching and the basis cache are shared with formVXC.
+   *
+   *  Only implemented for 1C (RKS / UKS) references. If a trial density
+   *  has no MZ component it is taken to be zero.
+   *
+   *  \param [in/out] cont  Trial densities and storage for the contractions
+   */
+  template <typename T>
+  void KohnSham<T>::contractFXC(std::vector<XCKernelContraction> &cont) {
+
+    if( cont.size() == 0 ) return;
+
+    if( this->onePDM.size() > 2 )
+      CErr("XC kernel contraction is not implemented for 2C references");
+
+    for(auto &C : cont)
+      if( C.X.size() == 0 or C.X.size() > 2 or C.AX.size() == 0 or
+          C.AX.size() > 2 )
+        CErr("XC kernel contraction requires SCALAR (and MZ) components");
+
+    CQMemTag memTag(this->memManager,"FXC");
+
+    assert( intParam.nRad % intParam.nRadPerBatch == 0 );
+
+    size_t NPtsMaxPerBatch = intParam.nRadPerBatch * intParam.nAng;
+
+    bool isGGA = std::any_of(functionals.begin(),functionals.end(),
+                   [](std::shared_ptr<DFTFunctional> &x) {return x->isGGA(); });
+
+    SHELL_EVAL_TYPE typ = isGGA ? GRADIENT : NOGRAD;
+
+    size_t nthreads = GetNumThreads();
+    size_t LAThreads = GetLAThreads();
+
+    // Turn off LA threads
+    SetLAThreads(1);
+
+    BasisSet &basis = this->aoints.basisSet();
+    size_t NB = basis.nBasis;
+
+    for(auto &C : cont)
+    for(auto &X : C.AX) std::fill_n(X,NB*NB,0.);
+    std::vector<std::mutex> colLocks(basis.nShell);
+
+    // Same grid as formVXC
+    if( not molGrid ) molGrid = std::make_shared<MolecularGrid>();
+
+    BeckeIntegrator<EulerMac>
+      integrator(this->memManager,this->aoints.molecule(),basis,
+      EulerMac(intParam.nRad), intParam.nAng, intParam.nRadPerBatch,
+        typ, intParam.epsilon, intParam.scheme, intParam.prune,
+        intParam.boxBatch, intParam.basisCacheMem, molGrid);
+
+    integrator.prepareGrid();
+    size_t NBEMax = std::max(molGrid->maxNBE(),size_t(1));
+
+    // Allocating Memory
+    // ---------------------------------------------------------------------//
+
+    double *SCRATCHNBNB  =
+      this->memManager.template malloc<double>(nthreads*NBEMax*NBEMax);
+    double *SCRATCHNBNP  =
+      this->memManager.template malloc<double>(nthreads*NPtsMaxPerBatch*NBEMax);
+    double *ZMAT =
+      this->memManager.template malloc<double>(nthreads*NPtsMaxPerBatch*NBEMax);
+
+    // Number of point quantities (per thread):
+    //   DenS, DenZ (1+1), U_n (2), V2Rho (3), SCR (21), trial DenS, DenZ (1+1)
+    //   GGA: GDenS, GDenZ (3+3), U_gamma (3), Vgamma (3),
+    //        V2RhoGamma, V2Gamma (6+6), trial GDenS, GDenZ (3+3)
+    size_t nPtVar = 30;
+    if( isGGA ) nPtVar += 30;
+
+    double *PTSCR =
+      this->memManager.template malloc<double>(nthreads*nPtVar*NPtsMaxPerBatch);
+
+    // Real parts of the densities
+    std::vector<double*> Re1PDM;
+    for(auto i = 0; i < this->onePDM.size(); i++) {
+      if( std::is_same<T,double>::value )
+        Re1PDM.push_back(reinterpret_cast<double*>(this->onePDM[i]));
+      else {
+        Re1PDM.push_back(this->memManager.template malloc<double>(NB*NB));
+        GetMatRE('N',NB,NB,1.,this->onePDM[i],NB,Re1PDM.back(),NB);
+      }
+    }
+
+    // ---------------------------------------------------------------------//
+    // End allocating Memory
+
+    auto fxcbuild = [&](size_t &res, std::vector<cart_t> &batch,
+      std::vector<double> &weights, size_t NBE, double *BasisEval,
+      std::vector<size_t> &batchEvalShells,
+      std::vector<std::pair<size_t,size_t>> &subMatCut) {
+
+      // intParam.epsilon / ntotalpts (NANG * NRAD * NATOMS)
+      double epsScreen = intParam.epsilon / this->aoints.molecule().nAtoms /
+        intParam.nAng / intParam.nRad;
+
+      epsScreen = std::max(epsScreen,std::numeric_limits<double>::epsilon());
+
+      size_t NPts = batch.size();
+      size_t IOff = NBE*NPts;
+
+      // Full index of the significant basis functions of the batch
+      std::vector<size_t> batchBf;
+      batchBf.reserve(NBE);
+      for(auto &cut : subMatCut)
+      for(auto mu = cut.first; mu < cut.second; mu++)
+        batchBf.emplace_back(mu);
+
+      size_t thread_id = GetThreadID();
+
+      // Setup local pointers
+      double * SCRATCHNBNB_loc = SCRATCHNBNB + thread_id * NBEMax*NBEMax;
+      double * SCRATCHNBNP_loc = SCRATCHNBNP + thread_id * NBEMax*NPtsMaxPerBatch;
+      double * ZMAT_loc        = ZMAT        + thread_id * NBEMax*NPtsMaxPerBatch;
+
+      double * PTSCR_loc = PTSCR + thread_id * nPtVar*NPtsMaxPerBatch;
+      auto nextPtVar = [&](size_t n) {
+        double *p = PTSCR_loc; PTSCR_loc += n*NPtsMaxPerBatch; return p;
+      };
+
+      double * DenS_loc  = nextPtVar(1);
+      double * DenZ_loc  = nextPtVar(1);
+      double * U_n_loc   = nextPtVar(2);
+      double * V2Rho_loc = nextPtVar(3);
+      double * SCR_loc   = nextPtVar(21);
+      double * DenTS_loc = nextPtVar(1);
+      double * DenTZ_loc = nextPtVar(1);
+
+      double *GDenS_loc = nullptr, *GDenZ_loc = nullptr, *U_gamma_loc = nullptr,
+             *Vgamma_loc = nullptr, *V2RhoGamma_loc = nullptr,
+             *V2Gamma_loc = nullptr, *GDenTS_loc = nullptr, *GDenTZ_loc = nullptr;
+
+      if( isGGA ) {
+        GDenS_loc      = nextPtVar(3);
+        GDenZ_loc      = nextPtVar(3);
+        U_gamma_loc    = nextPtVar(3);
+        Vgamma_loc     = nextPtVar(3);
+        V2RhoGamma_loc = nextPtVar(6);
+        V2Gamma_loc    = nextPtVar(6);
+        GDenTS_loc     = nextPtVar(3);
+        GDenTZ_loc     = nextPtVar(3);
+      }
+
+      // Ground state V variables
+      evalDen(typ, NPts, NBE, NB, subMatCut, SCRATCHNBNB_loc, SCRATCHNBNP_loc,
+        Re1PDM[SCALAR], DenS_loc, GDenS_loc, GDenS_loc + NPts,
+        GDenS_loc + 2*NPts, BasisEval);
+
+      // Coarse screen on Density
+      double MaxDenS_loc = *std::max_element(DenS_loc,DenS_loc+NPts);
+      if (MaxDenS_loc < epsScreen) return;
+
+      if( this->onePDM.size() > 1 )
+        evalDen(typ, NPts, NBE, NB, subMatCut, SCRATCHNBNB_loc,
+          SCRATCHNBNP_loc, Re1PDM[MZ], DenZ_loc, GDenZ_loc, GDenZ_loc + NPts,
+          GDenZ_loc + 2*NPts, BasisEval);
+      else {
+        std::fill_n(DenZ_loc,NPts,0.);
+        if( isGGA ) std::fill_n(GDenZ_loc,3*NPts,0.);
+      }
+
+      // V -> U variables
+      // U(+) = 0.5 * (SCALAR + MZ)
+      // U(-) = 0.5 * (SCALAR - MZ)
+      for(auto iPt = 0; iPt < NPts; iPt++) {
+        U_n_loc[2*iPt]     = 0.5 * (DenS_loc[iPt] + DenZ_loc[iPt]);
+        U_n_loc[2*iPt + 1] = 0.5 * (DenS_loc[iPt] - DenZ_loc[iPt]);
+      }
+
+      if( isGGA )
+      for(auto iPt = 0; iPt < NPts; iPt++) {
+
+        double gP[3], gM[3];
+        for(auto k = 0; k < 3; k++) {
+          gP[k] = 0.5 * (GDenS_loc[iPt + k*NPts] + GDenZ_loc[iPt + k*NPts]);
+          gM[k] = 0.5 * (GDenS_loc[iPt + k*NPts] - GDenZ_loc[iPt + k*NPts]);
+        }
+
+        U_gamma_loc[3*iPt]     = gP[0]*gP[0] + gP[1]*gP[1] + gP[2]*gP[2];
+        U_gamma_loc[3*iPt + 1] = gP[0]*gM[0] + gP[1]*gM[1] + gP[2]*gM[2];
+        U_gamma_loc[3*iPt + 2] = gM[0]*gM[0] + gM[1]*gM[1] + gM[2]*gM[2];
+
+      }
+
+      // Kernel derivatives wrt U variables (once per batch for all of the
+      // trial densities)
+      loadFXCder(NPts, U_n_loc, U_gamma_loc, Vgamma_loc, V2Rho_loc,
+        V2RhoGamma_loc, V2Gamma_loc, SCR_loc);
+
+      // Linear response of the potential [+,-], stored in SCR
+      //   dVRho (2 * NPts, [+,-] for each point)
+      //   dW    (6 * NPts, [+ X,Y,Z, - X,Y,Z] for each point)
+      double *dVRho = SCR_loc;
+      double *dW    = dVRho + 2*NPts;
+
+      for(auto &C : cont) {
+
+        evalDen(typ, NPts, NBE, NB, subMatCut, SCRATCHNBNB_loc,
+          SCRATCHNBNP_loc, C.X[SCALAR], DenTS_loc, GDenTS_loc,
+          GDenTS_loc + NPts, GDenTS_loc + 2*NPts, BasisEval);
+
+        if( C.X.size() > 1 )
+          evalDen(typ, NPts, NBE, NB, subMatCut, SCRATCHNBNB_loc,
+            SCRATCHNBNP_loc, C.X[MZ], DenTZ_loc, GDenTZ_loc,
+            GDenTZ_loc + NPts, GDenTZ_loc + 2*NPts, BasisEval);
+        else {
+          std::fill_n(DenTZ_loc,NPts,0.);
+          if( isGGA ) std::fill_n(GDenTZ_loc,3*NPts,0.);
+        }
+
+        for(auto iPt = 0; iPt < NPts; iPt++) {
+
+          double rP = 0.5 * (DenTS_loc[iPt] + DenTZ_loc[iPt]);
+          double rM = 0.5 * (DenTS_loc[iPt] - DenTZ_loc[iPt]);
+
+          const double *f = V2Rho_loc + 3*iPt;
+
+          // LDA: dv(s) = sum_s' f(s,s') drho(s')
+          dVRho[2*iPt]     = f[0]*rP + f[1]*rM;
+          dVRho[2*iPt + 1] = f[1]*rP + f[2]*rM;
+
+          if( not isGGA ) continue;
+
+          double gP[3], gM[3], gTP[3], gTM[3];
+          for(auto k = 0; k < 3; k++) {
+            gP[k]  = 0.5 * (GDenS_loc[iPt + k*NPts]  + GDenZ_loc[iPt + k*NPts]);
+            gM[k]  = 0.5 * (GDenS_loc[iPt + k*NPts]  - GDenZ_loc[iPt + k*NPts]);
+            gTP[k] = 0.5 * (GDenTS_loc[iPt + k*NPts] + GDenTZ_loc[iPt + k*NPts]);
+            gTM[k] = 0.5 * (GDenTS_loc[iPt + k*NPts] - GDenTZ_loc[iPt + k*NPts]);
+          }
+
+          // Linear response of the gammas [++,+-,--]
+          double sPP = 0., sPM = 0., sMM = 0.;
+          for(auto k = 0; k < 3; k++) {
+            sPP += 2. * gP[k] * gTP[k];
+            sPM += gP[k] * gTM[k] + gTP[k] * gM[k];
+            sMM += 2. * gM[k] * gTM[k];
+          }
+
+          const double *vs = Vgamma_loc     + 3*iPt;
+          const double *rs = V2RhoGamma_loc + 6*iPt;
+          const double *ss = V2Gamma_loc    + 6*iPt;
+
+          dVRho[2*iPt]     += rs[0]*sPP + rs[1]*sPM + rs[2]*sMM;
+          dVRho[2*iPt + 1] += rs[3]*sPP + rs[4]*sPM + rs[5]*sMM;
+
+          // Linear response of vgamma [++,+-,--]
+          double dvsPP = rs[0]*rP + rs[3]*rM + ss[0]*sPP + ss[1]*sPM + ss[2]*sMM;
+          double dvsPM = rs[1]*rP + rs[4]*rM + ss[1]*sPP + ss[3]*sPM + ss[4]*sMM;
+          double dvsMM = rs[2]*rP + rs[5]*rM + ss[2]*sPP + ss[4]*sPM + ss[5]*sMM;
+
+          // W(+) = 2 vgamma++ Del rho+ + vgamma+- Del rho-
+          // W(-) = 2 vgamma-- Del rho- + vgamma+- Del rho+
+          double *dWP = dW + 6*iPt;
+          double *dWM = dWP + 3;
+          for(auto k = 0; k < 3; k++) {
+            dWP[k] = 2.*dvsPP*gP[k] + 2.*vs[0]*gTP[k] + dvsPM*gM[k] + vs[1]*gTM[k];
+            dWM[k] = 2.*dvsMM*gM[k] + 2.*vs[2]*gTM[k] + dvsPM*gP[k] + vs[1]*gTP[k];
+          }
+
+        }
+
+        // Z -> K[D'] for each of the requested components
+        // (see formZ_vxc for the factor of 0.5 in the LDA part)
+        for(auto k = 0; k < C.AX.size(); k++) {
+
+          double sgn = (k == SCALAR) ? 1. : -1.;
+
+          memset(ZMAT_loc,0,IOff*sizeof(double));
+          for(auto iPt = 0; iPt < NPts; iPt++) {
+
+            double Fg = 0.5 * weights[iPt] *
+              (dVRho[2*iPt] + sgn * dVRho[2*iPt + 1]);
+
+            if( std::abs(Fg) > epsScreen )
+              DaxPy(NBE,Fg,BasisEval + iPt*NBE,1,ZMAT_loc + iPt*NBE,1);
+
+            if( not isGGA ) continue;
+
+            for(auto x = 0; x < 3; x++) {
+              double FgX = weights[iPt] *
+                (dW[6*iPt + x] + sgn * dW[6*iPt + 3 + x]);
+
+              if( std::abs(FgX) > epsScreen )
+                DaxPy(NBE,FgX,BasisEval + iPt*NBE + (x+1)*IOff,1,
+                  ZMAT_loc + iPt*NBE,1);
+            }
+
+          }
+
+          DSYR2K('L','N',NBE,NPts,1.,BasisEval,NBE,ZMAT_loc,NBE,0.,
+            SCRATCHNBNB_loc,NBE);
+
+          incXCBatch(C.AX[k],SCRATCHNBNB_loc,NBE,batchEvalShells,batchBf,
+            colLocks);
+
+        }
+
+      } // loop over trial densities
+
+    }; // FXC integrate
+
+    integrator.integrate<size_t>(fxcbuild);
+
+    // factor in the 4 pi (Lebedev) and built the upper triagolar part
+    for(auto &C : cont)
+    for(auto &X : C.AX) {
+      Scale(NB*NB,4*M_PI,X,1);
+      HerMat('L',NB,X,NB);
+    }
+
+    // Freeing the memory
+    // ----------------------------------------------------------------  //
+    this->memManager.free(SCRATCHNBNB,SCRATCHNBNP,ZMAT,PTSCR);
+
+    if( not std::is_same<T,double>::value )
+      for(auto &X : Re1PDM) this->memManager.free(X);
+
+    // Turn back on LA threads
+    SetLAThreads(LAThreads);
+
+  }; // KohnSham<T>::contractFXC
+
+}; // namespace ChronusQ
+
+#endif
@@ -32,6 +32,7 @@
   OP_MEMBER(this,other,isGGA_)\
   OP_MEMBER(this,other,functionals)\
   OP_MEMBER(this,other,intParam)\
+  OP_MEMBER(this,other,molGrid)\
   OP_MEMBER(this,other,XCEnergy)\
   OP_VEC_OP(double,this,other,this->memManager,VXC);
 
@@ -70,5 +71,6 @@ namespace ChronusQ {
 }; // namespace ChronusQ
 
 #include <singleslater/kohnsham/vxc.hpp> // VXC build
+#include <singleslater/kohnsham/fxc.hpp> // XC kernel contraction
 
 #endif
@@ -47,7 +47,11 @@ namespace ChronusQ {
    *  \brief wrapper for evaluating and loading the DFT 
    *  kernel derivatives from libxc wrt to the U var.
    *
-   *  Note. We compute all the quantities for all points in the batch.
+   *  Note. Only the points whose (total) density is above the density 
+   *  threshold (see denThreshold) are passed to libxc, packed contiguously,
+   *  the kernel derivatives of the remaining points are zero. The 
+   *  contributions of all of the functionals are accumulated (and scattered
+   *  back to the batch) in a single pass per functional.
    *
    *  \param [in]  NPts       Number of points in the batch
    *  \param [in]  Den        Pointer to the Uvar Density vector[+,-].
@@ -62,37 +66,79 @@ namespace ChronusQ {
    *                          the energy per unit volume in terms of 
    *                          the gammas[++,+-,--].
    *
-   *  \param [out] EpsSCR     Pointer for multiple functional eval. See epsEval
-   *  \param [out] VRhoSCR    Pointer for multiple functional eval. See VRhoEval
-   *  \param [out] VgammaSCR  Pointer for multiple functional eval. See VgammaEval
+   *  \param [out] EpsSCR     Pointer for single functional eval. See epsEval
+   *  \param [out] VRhoSCR    Pointer for single functional eval. See VRhoEval
+   *  \param [out] VgammaSCR  Pointer for single functional eval. See VgammaEval
+   *  \param [out] DenSCR     Pointer for the packed Den
+   *  \param [out] GammaSCR   Pointer for the packed Gamma
+   *  \param [out] PtMap      Pointer for the indices of the packed points
    */  
   template <typename T>
   void KohnSham<T>::loadVXCder(size_t NPts, double *Den, double *Gamma,
     double *epsEval, double*VRhoEval, double *VgammaEval, double *EpsSCR, 
-    double *VRhoSCR, double *VgammaSCR) { 
+    double *VRhoSCR, double *VgammaSCR, double *DenSCR, double *GammaSCR,
+    size_t *PtMap) { 
 
-    for(auto iF = 0; iF < functionals.size(); iF++) {
-      double *ES,*VR,*VS;
-      if( iF == 0 ) {
-        ES = epsEval;
-        VR = VRhoEval;
-        VS = VgammaEval;
-      } else {
-        ES = EpsSCR;
-        VR = VRhoSCR;
-        VS = VgammaSCR;
+    bool anyGGA = std::any_of(functionals.begin(),functionals.end(),
+                   [](std::shared_ptr<DFTFunctional> &x) {return x->isGGA(); }); 
+
+    // Zero out the kernel derivatives
+    std::fill_n(epsEval,NPts,0.);
+    std::fill_n(VRhoEval,2*NPts,0.);
+    if( anyGGA ) std::fill_n(VgammaEval,3*NPts,0.);
+
+    // Determine the significant points
+    double thresh = denThreshold();
+
+    size_t NSig = 0;
+    for(auto iPt = 0ul; iPt < NPts; iPt++)
+      if( Den[2*iPt] + Den[2*iPt+1] >= thresh ) PtMap[NSig++] = iPt;
+
+    if( NSig == 0 ) return;
+
+    // Pack the significant points
+    double *DenP = Den, *GammaP = Gamma;
+    if( NSig != NPts ) {
+
+      DenP = DenSCR; GammaP = GammaSCR;
+
+      for(auto p = 0ul; p < NSig; p++) {
+        size_t iPt = PtMap[p];
+        DenP[2*p]     = Den[2*iPt];
+        DenP[2*p + 1] = Den[2*iPt + 1];
+        if( anyGGA ) {
+          GammaP[3*p]     = Gamma[3*iPt];
+          GammaP[3*p + 1] = Gamma[3*iPt + 1];
+          GammaP[3*p + 2] = Gamma[3*iPt + 2];
+        }
       }
 
-      if( functionals[iF]->isGGA() )
-        functionals[iF]->evalEXC_VXC(NPts,Den,Gamma,ES,VR,VS);
+    }
+
+    for(auto iF = 0; iF < functionals.size(); iF++) {
+
+      bool GGA = functionals[iF]->isGGA();
+
+      if( GGA )
+        functionals[iF]->evalEXC_VXC(NSig,DenP,GammaP,EpsSCR,VRhoSCR,VgammaSCR);
       else
-        functionals[iF]->evalEXC_VXC(NPts,Den,ES,VR);
-      
-      if( iF != 0 ) {
-        MatAdd('N','N',NPts,1,1.,epsEval,NPts,1.,EpsSCR,NPts,epsEval,NPts);
-        MatAdd('N','N',2*NPts,1,1.,VRhoEval,2*NPts,1.,VRhoSCR,2*NPts,VRhoEval,2*NPts);
-      if( functionals[iF]->isGGA() )
-        MatAdd('N','N',3*NPts,1,1.,VgammaEval,3*NPts,1.,VgammaSCR,3*NPts,VgammaEval,3*NPts);
+        functionals[iF]->evalEXC_VXC(NSig,DenP,EpsSCR,VRhoSCR);
+
+      // Accumulate (and unpack)
+      for(auto p = 0ul; p < NSig; p++) {
+
+        size_t iPt = PtMap[p];
+
+        epsEval[iPt]        += EpsSCR[p];
+        VRhoEval[2*iPt]     += VRhoSCR[2*p];
+        VRhoEval[2*iPt + 1] += VRhoSCR[2*p + 1];
+
+        if( GGA ) {
+          VgammaEval[3*iPt]     += VgammaSCR[3*p];
+          VgammaEval[3*iPt + 1] += VgammaSCR[3*p + 1];
+          VgammaEval[3*iPt + 2] += VgammaSCR[3*p + 2];
+        }
+
       }
 
     }
@@ -120,6 +166,51 @@ namespace ChronusQ {
 
 
 
+  /**
+   *  \brief Scatter the (lower triangle of the) compact NBE x NBE 
+   *  contribution of a batch into a full NB x NB matrix.
+   *
+   *  \param [in/out] X               Full matrix (lower triangle)
+   *  \param [in]     SCR             Compact NBE x NBE batch contribution
+   *  \param [in]     NBE             Number of significant basis functions
+   *  \param [in]     batchEvalShells Significant shells of the batch
+   *  \param [in]     batchBf         Full index of the significant basis 
+   *                                  functions of the batch
+   *  \param [in]     colLocks        Guards for the columns of each shell
+   */  
+  template <typename T>
+  void KohnSham<T>::incXCBatch(double *X, const double *SCR, size_t NBE,
+    const std::vector<size_t> &batchEvalShells, 
+    const std::vector<size_t> &batchBf, std::vector<std::mutex> &colLocks) {
+
+    BasisSet &basis = this->aoints.basisSet();
+    size_t NB = basis.nBasis;
+
+    size_t cj = 0;
+    for(auto sj : batchEvalShells) {
+
+      size_t nj  = basis.shells[sj].size();
+      size_t bfj = basis.mapSh2Bf[sj];
+
+      std::lock_guard<std::mutex> lck(colLocks[sj]);
+      for(size_t c = 0; c < nj; c++) {
+
+        double       *XCol = X   + (bfj + c)*NB;
+        const double *SCol = SCR + (cj + c)*NBE;
+
+        for(size_t r = cj + c; r < NBE; r++) XCol[batchBf[r]] += SCol[r];
+
+      }
+
+      cj += nj;
+
+    }
+
+  }; // KohnSham<T>::incXCBatch
+
+
+
+
   /**
    *  \brief form the U variables given the V variables.
    *
@@ -344,8 +435,8 @@ namespace ChronusQ {
    *  \param [in]  NBE        Effective number of basis to be evalauted (only shell actives)
    *  \param [in]  NB         Total Number of basis.
    *  \param [in]  subMatCut  Pair to handle the cut of the shell submatrix to be evaluated.
-   *  \param [in]  SCR1       Pointer to an NB*NB scratch.
-   *  \param [in]  SCR2       Pointer to an NB*NPts scratch.
+   *  \param [in]  SCR1       Pointer to an NBE*NBE scratch.
+   *  \param [in]  SCR2       Pointer to an NBE*NPts scratch.
    *  \param [in]  DENMAT     Pointer to 1PDM (scalar, Mk).
    *  \param [out] Den        Pointer to the V variable - SCALAR/Mk
    *  \param [out] GDenX      Pointer to the V variable - Gradient X comp of SCALAR/Mk
@@ -823,6 +914,9 @@ namespace ChronusQ {
    */  
   template <typename T>
   void KohnSham<T>::formVXC() {
+
+    CQMemTag memTag(this->memManager,"VXC");
+
 #if VXC_DEBUG_LEVEL >= 1
     // TIMING 
     auto topMem = std::chrono::high_resolution_clock::now();
@@ -847,24 +941,25 @@ namespace ChronusQ {
     size_t NB = basis.nBasis;
     // Clean up all VXC components for a the evaluation for a new batch of points
 
-    std::vector<std::vector<double*>> integrateVXC;
-    double* intVXC_RAW = nullptr;
+    // The batch contributions are accumulated directly into VXC (lower
+    // triangle), the updates to the columns of shell s are guarded by
+    // colLocks[s]
+    for(auto &X : VXC) std::fill_n(X,NB*NB,0.);
+    std::vector<std::mutex> colLocks(basis.nShell);
 
-    if( nthreads != 1 )
-      intVXC_RAW = this->memManager.template malloc<double>(VXC.size() * nthreads * NB*NB);
+    // Create the BeckeIntegrator object (the molecular grid is built on
+    // the first call and reused thereafter)
+    if( not molGrid ) molGrid = std::make_shared<MolecularGrid>();
 
-    for(auto k = 0; k < VXC.size(); k++) {
-      if( nthreads != 1 ) {
-        integrateVXC.emplace_back();
-        for(auto ith = 0; ith < nthreads; ith++)
-          integrateVXC.back().emplace_back(intVXC_RAW + (ith + k*nthreads) * NB*NB);
-      } else {
-        integrateVXC.emplace_back();
-        integrateVXC.back().emplace_back(VXC[k]);
-      }
-    }
-    
-    for(auto &X : integrateVXC) for(auto &Y : X) std::fill_n(Y,NB*NB,0.);
+    BeckeIntegrator<EulerMac> 
+      integrator(this->memManager,this->aoints.molecule(),basis,
+      EulerMac(intParam.nRad), intParam.nAng, intParam.nRadPerBatch,
+        (isGGA ? GRADIENT : NOGRAD), intParam.epsilon, intParam.scheme,
+        intParam.prune, intParam.boxBatch, intParam.basisCacheMem, molGrid);
+
+    // The scratch only spans the significant basis functions of a batch
+    integrator.prepareGrid();
+    size_t NBEMax = std::max(molGrid->maxNBE(),size_t(1));
 
     std::vector<double> integrateXCEnergy(nthreads,0.);
 
@@ -885,9 +980,10 @@ namespace ChronusQ {
     // ---------------------------------------------------------------------//
     
     XCEnergy = 0.;
-    double *SCRATCHNBNB  = this->memManager.template malloc<double>(nthreads*NB*NB); 
+    double *SCRATCHNBNB  = 
+      this->memManager.template malloc<double>(nthreads*NBEMax*NBEMax); 
     double *SCRATCHNBNP  = 
-      this->memManager.template malloc<double>(nthreads*NPtsMaxPerBatch*NB); 
+      this->memManager.template malloc<double>(nthreads*NPtsMaxPerBatch*NBEMax); 
 
     double *DenS, *DenZ, *DenX, *DenY, *Mnorm ;
     double *KScratch;
@@ -939,17 +1035,23 @@ namespace ChronusQ {
       dVU_gamma = this->memManager.template malloc<double>(3*nthreads*NPtsMaxPerBatch); 
     }
 
-    double *epsSCR, *dVU_n_SCR, *dVU_gamma_SCR;
-    if( functionals.size() > 1 ) {
-      epsSCR    = this->memManager.template malloc<double>(nthreads*NPtsMaxPerBatch);
-      dVU_n_SCR    = this->memManager.template malloc<double>(2*nthreads*NPtsMaxPerBatch);
-      if(isGGA) 
-        dVU_gamma_SCR = 
-          this->memManager.template malloc<double>(3*nthreads*NPtsMaxPerBatch);
+    // Packed (significant point) kernel evaluation
+    double *epsSCR, *dVU_n_SCR, *dVU_gamma_SCR, *U_n_SCR, *U_gamma_SCR;
+    epsSCR    = this->memManager.template malloc<double>(nthreads*NPtsMaxPerBatch);
+    dVU_n_SCR = this->memManager.template malloc<double>(2*nthreads*NPtsMaxPerBatch);
+    U_n_SCR   = this->memManager.template malloc<double>(2*nthreads*NPtsMaxPerBatch);
+    if(isGGA) {
+      dVU_gamma_SCR = 
+        this->memManager.template malloc<double>(3*nthreads*NPtsMaxPerBatch);
+      U_gamma_SCR = 
+        this->memManager.template malloc<double>(3*nthreads*NPtsMaxPerBatch);
     }
+
+    size_t *PtMap = this->memManager.template malloc<size_t>(nthreads*NPtsMaxPerBatch);
  
     // ZMatrix
-    double *ZMAT = this->memManager.template malloc<double>(nthreads*NPtsMaxPerBatch*NB);
+    double *ZMAT = 
+      this->memManager.template malloc<double>(nthreads*NPtsMaxPerBatch*NBEMax);
  
     // Decide if we need to allocate space for real part of the densities
     // and copy over the real parts
@@ -980,6 +1082,7 @@ namespace ChronusQ {
     std::chrono::duration<double> durIncBySubMat(0.) ;
 #endif
 
+
     auto vxcbuild = [&](size_t &res, std::vector<cart_t> &batch, 
       std::vector<double> &weights, size_t NBE, double *BasisEval, 
       std::vector<size_t> &batchEvalShells, 
@@ -999,6 +1102,13 @@ namespace ChronusQ {
       size_t NPts = batch.size();
       size_t IOff = NBE*NPts;
 
+      // Full index of the significant basis functions of the batch
+      std::vector<size_t> batchBf;
+      batchBf.reserve(NBE);
+      for(auto &cut : subMatCut)
+      for(auto mu = cut.first; mu < cut.second; mu++)
+        batchBf.emplace_back(mu);
+
       size_t thread_id = GetThreadID();
 
 #if VXC_DEBUG_LEVEL >= 1
@@ -1007,8 +1117,8 @@ namespace ChronusQ {
 #endif
 
       // Setup local pointers
-      double * SCRATCHNBNB_loc = SCRATCHNBNB + thread_id * NB*NB;
-      double * SCRATCHNBNP_loc = SCRATCHNBNP + thread_id * NB*NPtsMaxPerBatch;
+      double * SCRATCHNBNB_loc = SCRATCHNBNB + thread_id * NBEMax*NBEMax;
+      double * SCRATCHNBNP_loc = SCRATCHNBNP + thread_id * NBEMax*NPtsMaxPerBatch;
 
       double * DenS_loc = DenS + thread_id * NPtsMaxPerBatch;
       double * DenZ_loc = DenZ + thread_id * NPtsMaxPerBatch;
@@ -1035,8 +1145,11 @@ namespace ChronusQ {
       double * epsSCR_loc        = epsSCR        + thread_id * NPtsMaxPerBatch;
       double * dVU_n_SCR_loc     = dVU_n_SCR     + thread_id * 2*NPtsMaxPerBatch;
       double * dVU_gamma_SCR_loc = dVU_gamma_SCR + thread_id * 3*NPtsMaxPerBatch;
+      double * U_n_SCR_loc       = U_n_SCR       + thread_id * 2*NPtsMaxPerBatch;
+      double * U_gamma_SCR_loc   = U_gamma_SCR   + thread_id * 3*NPtsMaxPerBatch;
+      size_t * PtMap_loc         = PtMap         + thread_id * NPtsMaxPerBatch;
 
-      double *ZMAT_loc = ZMAT + thread_id * NB*NPtsMaxPerBatch;
+      double *ZMAT_loc = ZMAT + thread_id * NBEMax*NPtsMaxPerBatch;
 
       //2C
       double * Mnorm_loc    = Mnorm        + thread_id * NPtsMaxPerBatch;
@@ -1115,7 +1228,7 @@ namespace ChronusQ {
 
       // Get DFT Energy derivatives wrt U variables
       loadVXCder(NPts, U_n_loc, U_gamma_loc, epsEval_loc, dVU_n_loc, dVU_gamma_loc, epsSCR_loc, 
-        dVU_n_SCR_loc, dVU_gamma_SCR_loc); 
+        dVU_n_SCR_loc, dVU_gamma_SCR_loc, U_n_SCR_loc, U_gamma_SCR_loc, PtMap_loc); 
 
 #if VXC_DEBUG_LEVEL >= 1
       // TIMING
@@ -1183,7 +1296,8 @@ namespace ChronusQ {
 
        // Locating the submatrix in the right position given the subset of 
        // shells for the given batch.
-       IncBySubMat(NB,NB,NBE,NBE,integrateVXC[SCALAR][thread_id],NB,SCRATCHNBNB_loc,NBE,subMatCut);
+       incXCBatch(VXC[SCALAR],SCRATCHNBNB_loc,NBE,batchEvalShells,batchBf,
+         colLocks);
  #if VXC_DEBUG_LEVEL >= 1
        // TIMING
        auto botIncBySubMat    = std::chrono::high_resolution_clock::now();
@@ -1252,7 +1366,8 @@ namespace ChronusQ {
   
         // Locating the submatrix in the right position given the subset of 
         // shells for the given batch.
-        IncBySubMat(NB,NB,NBE,NBE,integrateVXC[MZ][thread_id],NB,SCRATCHNBNB_loc,NBE,subMatCut);           
+        incXCBatch(VXC[MZ],SCRATCHNBNB_loc,NBE,batchEvalShells,batchBf,
+          colLocks);
       }
  
 
@@ -1290,7 +1405,8 @@ namespace ChronusQ {
     
           // Locating the submatrix in the right position given the subset of 
           // shells for the given batch.
-          IncBySubMat(NB,NB,NBE,NBE,integrateVXC[MY][thread_id],NB,SCRATCHNBNB_loc,NBE,subMatCut);           
+          incXCBatch(VXC[MY],SCRATCHNBNB_loc,NBE,batchEvalShells,batchBf,
+            colLocks);
         }
 
 //
@@ -1324,19 +1440,14 @@ namespace ChronusQ {
     
           // Locating the submatrix in the right position given the subset of 
           // shells for the given batch.
-          IncBySubMat(NB,NB,NBE,NBE,integrateVXC[MX][thread_id],NB,SCRATCHNBNB_loc,NBE,subMatCut);           
+          incXCBatch(VXC[MX],SCRATCHNBNB_loc,NBE,batchEvalShells,batchBf,
+            colLocks);
         }
       } // 2C My and Mz
 
     }; // VXC integrate
 
 
-    // Create the BeckeIntegrator object
-    BeckeIntegrator<EulerMac> 
-      integrator(this->memManager,this->aoints.molecule(),basis,
-      EulerMac(intParam.nRad), intParam.nAng, intParam.nRadPerBatch,
-        (isGGA ? GRADIENT : NOGRAD), intParam.epsilon);
-
     // Integrate the VXC
     integrator.integrate<size_t>(vxcbuild);
 
@@ -1349,13 +1460,7 @@ namespace ChronusQ {
     // factor in the 4 pi (Lebedev) and built the upper triagolar part
     // since we create only the lower triangular. For all components
     for(auto k = 0; k < VXC.size(); k++) {
-      if( nthreads == 1 )
-        Scale(NB*NB,4*M_PI,VXC[k],1);
-      else
-        for(auto ithread = 0; ithread < nthreads; ithread++)
-          MatAdd('N','N',NB,NB,((ithread == 0) ? 0. : 1.),VXC[k],NB,
-            4*M_PI,integrateVXC[k][ithread],NB, VXC[k],NB);
-      
+      Scale(NB*NB,4*M_PI,VXC[k],1);
       HerMat('L',NB,VXC[k],NB);
     }
 
@@ -1392,15 +1497,15 @@ namespace ChronusQ {
     std::cerr << "sum gamma        = " << 4*M_PI*sumgamma << std::endl;
     std::cerr << "EXC              = " << XCEnergy << std::endl;
     prettyPrintSmart(std::cerr,"onePDM Scalar",this->onePDM[SCALAR],NB,NB,NB);
-    prettyPrintSmart(std::cerr,"Numerical Scalar VXC ",integrateVXC[SCALAR][0],NB,NB,NB);
+    prettyPrintSmart(std::cerr,"Numerical Scalar VXC ",VXC[SCALAR],NB,NB,NB);
     if( not this->iCS ) { 
      prettyPrintSmart(std::cerr,"onePDM Mz",this->onePDM[MZ],NB,NB,NB);
-     prettyPrintSmart(std::cerr,"Numerical Mz VXC",integrateVXC[MZ][0],NB,NB,NB);
+     prettyPrintSmart(std::cerr,"Numerical Mz VXC",VXC[MZ],NB,NB,NB);
      if( this->onePDM.size() > 2 ) {
      prettyPrintSmart(std::cerr,"onePDM My",this->onePDM[MY],NB,NB,NB);
-     prettyPrintSmart(std::cerr,"Numerical My VXC",integrateVXC[MY][0],NB,NB,NB);
+     prettyPrintSmart(std::cerr,"Numerical My VXC",VXC[MY],NB,NB,NB);
      prettyPrintSmart(std::cerr,"onePDM Mx",this->onePDM[MX],NB,NB,NB);
-     prettyPrintSmart(std::cerr,"Numerical Mx VXC",integrateVXC[MX][0],NB,NB,NB);
+     prettyPrintSmart(std::cerr,"Numerical Mx VXC",VXC[MX],NB,NB,NB);
      }
     }
 #endif
@@ -1421,13 +1526,9 @@ namespace ChronusQ {
       if( isGGA )  this->memManager.free(GDenX,GDenY,HScratch);
     }
 
-    if( functionals.size() > 1 ) {
-      this->memManager.free(epsSCR,dVU_n_SCR);
-      if( isGGA ) this->memManager.free(dVU_gamma_SCR);
-    }
-
+    this->memManager.free(epsSCR,dVU_n_SCR,U_n_SCR,PtMap);
+    if( isGGA ) this->memManager.free(dVU_gamma_SCR,U_gamma_SCR);
 
-    if( nthreads != 1 ) this->memManager.free(intVXC_RAW);
 
     if( not std::is_same<T,double>::value )
       for(auto &X : Re1PDM) this->memManager.free(X);
@@ -28,6 +28,7 @@
 #include <util/matout.hpp>
 #include <cqlinalg/blas1.hpp>
 #include <cqlinalg/blasutil.hpp>
+#include <cqlinalg/matfunc.hpp>
 
 // SCF definitions for SingleSlaterBase
 #include <singleslater/base/scf.hpp> 
@@ -120,37 +121,88 @@ namespace ChronusQ {
   /**
    *  \brief Obtain a new set of orbitals given a Fock matrix.
    *
-   *  Currently implements the fixed-point SCF procedure.
+   *  Currently implements the fixed-point SCF procedure. If requested,
+   *  the density is obtained by purification of the Fock matrix 
+   *  (no orbitals, see purifyOrthoFock) during the SCF iterations, or the
+   *  orbitals are obtained by a quasi-Newton rotation once the orbital
+   *  gradient is small (see soscfOrbitals).
    */ 
   template <typename T>
   void SingleSlater<T>::getNewOrbitals(EMPerturbation &pert, bool frmFock) {
 
+    // Increment the Fock matrix with the change in the density unless
+    // this is the first iteration, nIncFock incremental builds have been
+    // performed, or the accumulated screening error has grown large 
+    // relative to the current change in the density
     bool increment = scfControls.doIncFock and 
-                     scfConv.nSCFIter % scfControls.nIncFock != 0 and
-                     scfControls.guess != RANDOM;
+                     scfConv.nSCFIter != 0 and
+                     scfControls.guess != RANDOM and
+                     scfConv.nIncFockIter < scfControls.nIncFock and
+                     scfConv.incFockError <= 
+                       scfControls.incFockResetTol * scfConv.RMSDenScalar;
 
     // Form the Fock matrix D(k) -> F(k)
-    if( frmFock ) formFock(pert,increment);
+    if( frmFock ) {
+
+      // Adaptive density difference screening threshold: tightens as the
+      // change in the density decreases
+      if( increment ) {
+        scfConv.incFockThresh = std::max(aoints.threshSchwartz,
+          scfControls.incFockScale * scfConv.RMSDenScalar);
+        scfConv.incFockError += scfConv.incFockThresh;
+        scfConv.nIncFockIter++;
+      } else {
+        scfConv.incFockThresh = aoints.threshSchwartz;
+        scfConv.incFockError  = 0.;
+        scfConv.nIncFockIter  = 0;
+      }
+
+      scfConv.incFockBuild = increment;
+
+      aoints.threshDenScreen = scfConv.incFockThresh;
+      aoints.nQuartetScreened = 0; aoints.nQuartetTotal = 0;
+
+      formFock(pert,increment);
+
+      aoints.threshDenScreen = 0.;
+
+      scfConv.nQuartetScreened = aoints.nQuartetScreened;
+      scfConv.nQuartetTotal    = aoints.nQuartetTotal;
+
+    }
 
     // Transform AO fock into the orthonormal basis
     ao2orthoFock();
 
+    // Rotate the orbitals by a quasi-Newton step near convergence
+    bool rotated = scfControls.doSOSCF and frmFock and soscfOrbitals();
+
     // Modify fock matrix if requested
-    if( scfControls.doExtrap and frmFock ) modifyFock();
+    if( scfControls.doExtrap and frmFock and not rotated ) modifyFock();
+
+    // Purify the orthonormal fock matrix (directly populates onePDMOrtho),
+    // fall back to diagonalization if the purification fails
+    bool purified = scfControls.doPurify and frmFock and not rotated and 
+      purifyOrthoFock();
 
-    // Diagonalize the orthonormal fock Matrix
-    diagOrthoFock();
+    if( not purified ) {
 
-    // Form the orthonormal density (in the AO storage)
-    formDensity();
+      // Diagonalize the orthonormal fock Matrix (only the occupied and
+      // nEigVirt virtual orbitals are needed during the SCF iterations)
+      if( not rotated ) diagOrthoFock(frmFock and scfControls.nEigVirt >= 0);
 
-    // Copy the AO storage to orthonormal storage and back transform
-    // the density into the AO basis. This is because ortho2aoDen
-    // requires the onePDMOrtho storage is populated.
-    for(auto i = 0; i < this->onePDM.size(); i++)
-      std::copy_n(this->onePDM[i],
-        memManager.template getSize(onePDMOrtho[i]),
-        onePDMOrtho[i]);
+      // Form the orthonormal density (in the AO storage)
+      formDensity();
+
+      // Copy the AO storage to orthonormal storage and back transform
+      // the density into the AO basis. This is because ortho2aoDen
+      // requires the onePDMOrtho storage is populated.
+      for(auto i = 0; i < this->onePDM.size(); i++)
+        std::copy_n(this->onePDM[i],
+          memManager.template getSize(onePDMOrtho[i]),
+          onePDMOrtho[i]);
+
+    }
 
     // Transform the orthonormal density to the AO basis
     ortho2aoDen();
@@ -284,9 +336,12 @@ namespace ChronusQ {
    *  fock matrix and stores a set of orthonormal MO coefficients
    *  (in WaveFunction::mo1 and possibly WaveFunction::mo2) and
    *  orbital energies. General for both 1 and 2 spin components
+   *
+   *  \param [in] partial Only obtain the occupied and 
+   *                      SCFControls::nEigVirt virtual orbitals
    */ 
   template <typename T>
-  void SingleSlater<T>::diagOrthoFock() {
+  void SingleSlater<T>::diagOrthoFock(bool partial) {
 
     size_t NB = aoints.basisSet().nBasis * nC;
     size_t NB2 = NB*NB;
@@ -309,13 +364,20 @@ namespace ChronusQ {
     }
 
     // Diagonalize the Fock Matrix
-    int INFO = HermetianEigen('V', 'L', NB, this->mo1, NB, this->eps1, 
-      memManager );
+    auto diag = [&](T *MO, double *EPS, size_t nOcc) -> int {
+      if( partial )
+        return HermetianEigen('V', 'L', NB, 
+          std::min(NB, nOcc + scfControls.nEigVirt), MO, NB, EPS, memManager);
+      else
+        return HermetianEigen(scfControls.eigAlg, 'V', 'L', NB, MO, NB, EPS, 
+          memManager);
+    };
+
+    int INFO = diag(this->mo1, this->eps1, (nC == 1) ? this->nOA : this->nO);
     if( INFO != 0 ) CErr("HermetianEigen failed in Fock1",std::cout);
 
     if(nC == 1 and not iCS) {
-      INFO = HermetianEigen('V', 'L', NB, this->mo2, NB, this->eps2, 
-        memManager );
+      INFO = diag(this->mo2, this->eps2, this->nOB);
       if( INFO != 0 ) CErr("HermetianEigen failed in Fock2",std::cout);
     }
 
@@ -326,6 +388,84 @@ namespace ChronusQ {
   }; // SingleSlater<T>::diagOrthoFock
 
 
+  /**
+   *  \brief Form the orthonormal density from the orthonormal fock 
+   *  matrix by purification (see Purify), i.e. without diagonalization.
+   *
+   *  Populates / overwrites onePDMOrtho storage. General for both 1 and 2
+   *  spin components. The MOs and orbital energies are not updated.
+   *
+   *  \returns Whether the purification converged
+   */ 
+  template <typename T>
+  bool SingleSlater<T>::purifyOrthoFock() {
+
+    size_t NB = aoints.basisSet().nBasis * nC;
+    size_t NB2 = NB*NB;
+
+    // Scratch is persistent over the SCF iterations (see SCFInit)
+    T* FSCR  = purifySCR;
+    T* PSCR  = FSCR  + NB2;
+    T* PASCR = PSCR  + NB2;
+    T* SCR   = PASCR + NB2; // 2 x NB2 for Purify
+
+    auto purify = [&](size_t nOcc) -> bool {
+      return Purify(scfControls.purifyAlg, NB, nOcc, FSCR, NB, PSCR, NB,
+        scfControls.purifyTol, scfControls.maxPurifyIter, SCR) >= 0;
+    };
+
+    bool conv;
+    if(nC == 1 and iCS) {
+
+      std::transform(fockOrtho[SCALAR],fockOrtho[SCALAR] + NB2,FSCR,
+        [](T a){ return a / 2.; }
+      );
+
+      // DS = 2 * DA
+      if( (conv = purify(this->nOA)) )
+        std::transform(PSCR,PSCR + NB2,onePDMOrtho[SCALAR],
+          [](T a){ return 2.*a; }
+        );
+
+    } else if(nC == 1) {
+
+      for(auto j = 0; j < NB2; j++)
+        FSCR[j] = 0.5 * (fockOrtho[SCALAR][j] + fockOrtho[MZ][j]);
+
+      conv = purify(this->nOA);
+      std::copy_n(PSCR,NB2,PASCR);
+
+      for(auto j = 0; j < NB2; j++)
+        FSCR[j] = 0.5 * (fockOrtho[SCALAR][j] - fockOrtho[MZ][j]);
+
+      // DS = DA + DB
+      // DZ = DA - DB
+      if( conv and (conv = purify(this->nOB)) )
+        for(auto j = 0; j < NB2; j++) {
+          onePDMOrtho[SCALAR][j] = PASCR[j] + PSCR[j];
+          onePDMOrtho[MZ][j]     = PASCR[j] - PSCR[j];
+        }
+
+    } else {
+
+      SpinGather(NB/2,FSCR,NB,fockOrtho[SCALAR],NB/2,fockOrtho[MZ],
+        NB/2,fockOrtho[MY],NB/2,fockOrtho[MX],NB/2);
+
+      if( (conv = purify(this->nO)) )
+        SpinScatter(NB/2,PSCR,NB,onePDMOrtho[SCALAR],NB/2,onePDMOrtho[MZ],
+          NB/2,onePDMOrtho[MY],NB/2,onePDMOrtho[MX],NB/2);
+
+    }
+
+    if( not conv and printLevel > 0 )
+      std::cout << "    *** Purification Failed to Converge -- "
+                << "Diagonalizing the Fock Matrix ***" << std::endl;
+
+    return conv;
+
+  }; // SingleSlater<T>::purifyOrthoFock
+
+
   /**
    *  \brief Transforms all of the spin components of the AO fock
    *  matrix to the orthonormal basis.
@@ -439,7 +579,8 @@ namespace ChronusQ {
   /**
    *  \brief Initializes the environment for the SCF caluclation.
    *
-   *  Allocate memory for extrapolation and compute the energy
+   *  Allocate memory for extrapolation / second-order SCF / purification
+   *  and compute the energy
    */ 
   template <typename T>
   void SingleSlater<T>::SCFInit() {
@@ -447,6 +588,25 @@ namespace ChronusQ {
     // Allocate additional storage if doing some type of 
     // extrapolation during the SCF procedure
     if ( scfControls.doExtrap ) allocExtrapStorage();
+    scfConv.nDIISIter = 0;
+
+    // The orbital rotations require the complete set of MOs
+    if ( scfControls.doSOSCF ) {
+
+      if( scfControls.doPurify or scfControls.nEigVirt >= 0 )
+        CErr("Second-order SCF requires all of the orbitals during the SCF "
+             "iterations (no purification or partial diagonalization)");
+
+      allocSOSCFStorage();
+      scfConv.nSOSCFIter = 0;
+
+    }
+
+    // Purification scratch (Fock, alpha / beta densities + 2 NB2 for Purify)
+    if ( scfControls.doPurify ) {
+      size_t NB = aoints.basisSet().nBasis * nC;
+      purifySCR = memManager.template malloc<T>(5*NB*NB);
+    }
 
   }; // SingleSlater<T>::SCFInit
 
@@ -456,15 +616,27 @@ namespace ChronusQ {
   /**
    *  \brief Finalizes the environment for the SCF caluclation.
    *
-   *  Deallocate the memory allocated for extrapolation.
+   *  Deallocate the memory allocated for extrapolation / purification.
    */ 
   template <typename T>
   void SingleSlater<T>::SCFFin() {
 
+    // The MOs are not (all) updated by the purification or the partial
+    // diagonalization, and are not canonical after orbital rotations, 
+    // obtain them from the final Fock matrix
+    if( scfControls.doPurify or scfControls.nEigVirt >= 0 or 
+        scfControls.doSOSCF ) diagOrthoFock();
+
     ortho2aoMOs();
 
     // Deallocate extrapolation storage
     if ( scfControls.doExtrap ) deallocExtrapStorage();
+    if ( scfControls.doSOSCF  ) deallocSOSCFStorage();
+
+    if ( purifySCR != nullptr ) {
+      memManager.free(purifySCR);
+      purifySCR = nullptr;
+    }
 
   }; // SingleSlater<T>::SCFFin
 
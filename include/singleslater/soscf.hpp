@@ -0,0 +1,349 @@
+/* 
+ *  This file is part of the Chronus Quantum (ChronusQ) software package
+ *  
+ *  Copyright (C) 2014-2017 Li Research Group (University of Washington)
+ *  
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *  
+ *  Contact the Developers:
+ *    E-Mail: xsli@uw.edu
+ *  
+ */
+#ifndef __INCLUDED_SINGLESLATER_SOSCF_HPP__
+#define __INCLUDED_SINGLESLATER_SOSCF_HPP__
+
+#include <singleslater.hpp>
+#include <cqlinalg/blas1.hpp>
+#include <cqlinalg/blas3.hpp>
+#include <cqlinalg/blasutil.hpp>
+#include <cqlinalg/matfunc.hpp>
+
+namespace ChronusQ {
+
+  /**
+   *  \brief Allocates storage for the L-BFGS history of the second-order
+   *  SCF
+   */ 
+  template <typename T>
+  void SingleSlater<T>::allocSOSCFStorage() {
+
+    soscfStep.clear();
+    soscfDGrad.clear();
+    soscfRho.assign(scfControls.soscfNKeep,0.);
+
+    size_t N = nOrbRot();
+
+    for(auto i = 0; i < scfControls.soscfNKeep; i++) {
+      soscfStep.emplace_back(memManager.template malloc<T>(N));
+      soscfDGrad.emplace_back(memManager.template malloc<T>(N));
+    }
+
+    soscfPrevGrad = memManager.template malloc<T>(N);
+
+  }; // SingleSlater<T>::allocSOSCFStorage
+
+
+
+  /**
+   *  \brief Deallocates storage for the L-BFGS history of the second-order
+   *  SCF
+   */ 
+  template <typename T>
+  void SingleSlater<T>::deallocSOSCFStorage() {
+
+    for( auto &S : soscfStep  ) memManager.free(S);
+    for( auto &Y : soscfDGrad ) memManager.free(Y);
+    memManager.free(soscfPrevGrad);
+
+    soscfStep.clear();
+    soscfDGrad.clear();
+    soscfPrevGrad = nullptr;
+
+  }; // SingleSlater<T>::deallocSOSCFStorage
+
+
+
+  /**
+   *  \brief Number of (complex) virtual-occupied orbital rotation 
+   *  parameters. For unrestricted references, the alpha and beta
+   *  rotations are stored contiguously.
+   */ 
+  template <typename T>
+  size_t SingleSlater<T>::nOrbRot() {
+
+    size_t NB = aoints.basisSet().nBasis * nC;
+
+    if( nC == 1 and iCS ) return this->nOA * (NB - this->nOA);
+    else if( nC == 1 )
+      return this->nOA * (NB - this->nOA) + this->nOB * (NB - this->nOB);
+    else return this->nO * (NB - this->nO);
+
+  }; // SingleSlater<T>::nOrbRot
+
+
+
+  /**
+   *  \brief Evaluates the orbital gradient, the virtual-occupied block
+   *  of the Fock matrix in the current (orthonormal) MO basis,
+   *
+   *    G(a,i) = C(:,a)**H * F * C(:,i),
+   *
+   *  along with the diagonal approximation to the orbital Hessian,
+   *  H(a,i) = F(a,a) - F(i,i). G and H are stored virtual index fastest.
+   *
+   *  \param [out] G Orbital gradient   (nOrbRot)
+   *  \param [out] H Diagonal Hessian   (nOrbRot)
+   */ 
+  template <typename T>
+  void SingleSlater<T>::orbitalGradient(T *G, double *H) {
+
+    size_t NB  = aoints.basisSet().nBasis * nC;
+    size_t NB2 = NB*NB;
+
+    // Pairs with small or inverted orbital energy differences are kept
+    // from producing large steps
+    const double minHess = 0.05;
+
+    T* FSCR  = memManager.template malloc<T>(NB2);
+    T* FCSCR = memManager.template malloc<T>(NB2);
+    double* EPS = memManager.template malloc<double>(NB);
+
+    auto blockGrad = [&](T *MO, size_t nOcc) {
+
+      size_t nVirt = NB - nOcc;
+
+      // FC = F * C
+      Gemm('N','N',NB,NB,NB,T(1.),FSCR,NB,MO,NB,T(0.),FCSCR,NB);
+
+      // G = C(:,virt)**H * FC(:,occ)
+      Gemm('C','N',nVirt,nOcc,NB,T(1.),MO + nOcc*NB,NB,FCSCR,NB,T(0.),
+        G,nVirt);
+
+      // Diagonal of the Fock matrix in the MO basis
+      for(auto p = 0; p < NB; p++)
+        EPS[p] = InnerProd<double>(NB,MO + p*NB,1,FCSCR + p*NB,1);
+
+      for(auto i = 0; i < nOcc;  i++)
+      for(auto a = 0; a < nVirt; a++)
+        H[a + i*nVirt] = std::max(EPS[nOcc + a] - EPS[i], minHess);
+
+      G += nOcc*nVirt;
+      H += nOcc*nVirt;
+
+    };
+
+    if(nC == 1 and iCS) {
+
+      std::transform(fockOrtho[SCALAR],fockOrtho[SCALAR] + NB2,FSCR,
+        [](T a){ return a / 2.; }
+      );
+      blockGrad(this->mo1,this->nOA);
+
+    } else if(nC == 1) {
+
+      for(auto j = 0; j < NB2; j++)
+        FSCR[j] = 0.5 * (fockOrtho[SCALAR][j] + fockOrtho[MZ][j]); 
+      blockGrad(this->mo1,this->nOA);
+
+      for(auto j = 0; j < NB2; j++)
+        FSCR[j] = 0.5 * (fockOrtho[SCALAR][j] - fockOrtho[MZ][j]); 
+      blockGrad(this->mo2,this->nOB);
+
+    } else {
+
+      SpinGather(NB/2,FSCR,NB,fockOrtho[SCALAR],NB/2,fockOrtho[MZ],
+        NB/2,fockOrtho[MY],NB/2,fockOrtho[MX],NB/2);
+      blockGrad(this->mo1,this->nO);
+
+    }
+
+    memManager.free(FSCR,FCSCR,EPS);
+
+  }; // SingleSlater<T>::orbitalGradient
+
+
+
+  /**
+   *  \brief Rotates the (orthonormal) MOs by a set of virtual-occupied
+   *  rotation parameters
+   *
+   *    C <- C * exp(K),  K(a,i) = kappa(a,i),  K(i,a) = -conj(kappa(a,i))
+   *
+   *  \param [in] kappa Rotation parameters (nOrbRot, see orbitalGradient)
+   */ 
+  template <typename T>
+  void SingleSlater<T>::rotateOrbitals(T *kappa) {
+
+    size_t NB  = aoints.basisSet().nBasis * nC;
+    size_t NB2 = NB*NB;
+
+    T* XSCR = memManager.template malloc<T>(NB2);
+    T* KSCR = memManager.template malloc<T>(NB2);
+    T* USCR = memManager.template malloc<T>(NB2);
+
+    auto blockRotate = [&](T *MO, size_t nOcc) {
+
+      size_t nVirt = NB - nOcc;
+
+      // K = X - X**H, X(a,i) = kappa(a,i)
+      std::fill_n(XSCR,NB2,T(0.));
+      for(auto i = 0; i < nOcc;  i++)
+      for(auto a = 0; a < nVirt; a++)
+        XSCR[(nOcc + a) + i*NB] = kappa[a + i*nVirt];
+
+      MatAdd('N','C',NB,NB,T(1.),XSCR,NB,T(-1.),XSCR,NB,KSCR,NB);
+
+      // U = exp(K)
+      MatExpTaylor(NB,KSCR,NB,USCR,NB,memManager);
+
+      // C <- C * U
+      Gemm('N','N',NB,NB,NB,T(1.),MO,NB,USCR,NB,T(0.),XSCR,NB);
+      std::copy_n(XSCR,NB2,MO);
+
+      kappa += nOcc*nVirt;
+
+    };
+
+    if(nC == 1) {
+      blockRotate(this->mo1,this->nOA);
+      if( not iCS ) blockRotate(this->mo2,this->nOB);
+    } else
+      blockRotate(this->mo1,this->nO);
+
+    memManager.free(XSCR,KSCR,USCR);
+
+  }; // SingleSlater<T>::rotateOrbitals
+
+
+
+  /**
+   *  \brief Second-order SCF step. Obtains a new set of (orthonormal) MOs
+   *  by a quasi-Newton (L-BFGS) orbital rotation rather than by 
+   *  diagonalization of the orthonormal Fock matrix.
+   *
+   *  The inverse Hessian is built up from the previous steps and changes
+   *  in the orbital gradient starting from the diagonal approximation 
+   *  (see orbitalGradient). The step is only taken once the norm of the 
+   *  orbital gradient falls below SCFControls::soscfStartTol, and is 
+   *  restricted to a maximum rotation of SCFControls::soscfMaxStep. If a
+   *  step increases the norm of the orbital gradient, the L-BFGS history
+   *  is discarded and the first-order SCF (extrapolation and 
+   *  diagonalization) takes the next step.
+   *
+   *  Requires the MOs to be consistent with the density from which the
+   *  current Fock matrix was formed.
+   *
+   *  \returns Whether the orbitals were rotated
+   */ 
+  template <typename T>
+  bool SingleSlater<T>::soscfOrbitals() {
+
+    // The orbitals of the guess need not be consistent with the density
+    if( scfConv.nSCFIter == 0 ) {
+      scfConv.nSOSCFIter = 0;
+      return false;
+    }
+
+    size_t N = nOrbRot();
+
+    T* G      = memManager.template malloc<T>(N);
+    T* R      = memManager.template malloc<T>(N);
+    double* H = memManager.template malloc<double>(N);
+
+    // Gradient norm prior to the last step
+    double prevNrmOrbGrad = scfConv.nrmOrbGrad;
+
+    orbitalGradient(G,H);
+    scfConv.nrmOrbGrad = TwoNorm<double>(N,G,1);
+
+    // The last quasi-Newton step increased the orbital gradient
+    bool uphill = scfConv.nSOSCFIter > 0 and 
+                  scfConv.nrmOrbGrad > prevNrmOrbGrad;
+
+    // Fall back to the first-order SCF far from convergence or if the
+    // last step went uphill (the L-BFGS history is discarded)
+    if( scfConv.nrmOrbGrad > scfControls.soscfStartTol or uphill ) {
+      scfConv.nSOSCFIter = 0;
+      memManager.free(G,R,H);
+      return false;
+    }
+
+    size_t nKeep = scfControls.soscfNKeep;
+    size_t nIter = scfConv.nSOSCFIter;
+    size_t nHist = std::min(nIter,nKeep);
+
+    // Complete the correction pair of the previous step,
+    //   y = G(k) - G(k-1), pairs which violate the curvature condition
+    //   (Re<y,s> <= 0) are dropped (rho = 0)
+    if( nIter > 0 ) {
+
+      size_t iHist = (nIter - 1) % nKeep;
+      for(auto j = 0; j < N; j++)
+        soscfDGrad[iHist][j] = G[j] - soscfPrevGrad[j];
+
+      double ys = InnerProd<double>(N,soscfDGrad[iHist],1,soscfStep[iHist],1);
+      soscfRho[iHist] = (ys > 0.) ? 1. / ys : 0.;
+
+    }
+
+    // L-BFGS two-loop recursion, R = H**-1 * G
+    std::copy_n(G,N,R);
+    std::vector<double> alpha(nHist);
+
+    for(auto m = 0; m < nHist; m++) {
+      size_t iHist = (nIter - 1 - m) % nKeep;
+      alpha[m] = soscfRho[iHist] * 
+        InnerProd<double>(N,soscfStep[iHist],1,R,1);
+      for(auto j = 0; j < N; j++) R[j] -= alpha[m] * soscfDGrad[iHist][j];
+    }
+
+    for(auto j = 0; j < N; j++) R[j] /= H[j];
+
+    for(int m = int(nHist) - 1; m >= 0; m--) {
+      size_t iHist = (nIter - 1 - m) % nKeep;
+      double beta = soscfRho[iHist] * 
+        InnerProd<double>(N,soscfDGrad[iHist],1,R,1);
+      for(auto j = 0; j < N; j++) 
+        R[j] += (alpha[m] - beta) * soscfStep[iHist][j];
+    }
+
+    // Step = -H**-1 * G, restricted to the maximum rotation
+    double maxRot = 0.;
+    for(auto j = 0; j < N; j++) maxRot = std::max(maxRot,std::abs(R[j]));
+
+    double scale = -1.;
+    if( maxRot > scfControls.soscfMaxStep )
+      scale *= scfControls.soscfMaxStep / maxRot;
+
+    for(auto j = 0; j < N; j++) R[j] *= scale;
+
+    // Save the step and the gradient for the next correction pair
+    std::copy_n(R,N,soscfStep[nIter % nKeep]);
+    std::copy_n(G,N,soscfPrevGrad);
+
+    // C <- C * exp(K)
+    rotateOrbitals(R);
+
+    scfConv.nSOSCFIter++;
+
+    memManager.free(G,R,H);
+
+    return true;
+
+  }; // SingleSlater<T>::soscfOrbitals
+
+}; // namespace ChronusQ
+
+#endif
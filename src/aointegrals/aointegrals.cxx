@@ -30,9 +30,19 @@
   
 #define AOIntegrals_COLLECTIVE_OP(OP_MEMBER, OP_OP, OP_VEC_OP) \
     OP_MEMBER(this,other,threshSchwartz); \
+    OP_MEMBER(this,other,threshDenScreen); \
     OP_MEMBER(this,other,cAlg); \
+    OP_MEMBER(this,other,eriStore); \
     OP_MEMBER(this,other,orthoType); \
     OP_MEMBER(this,other,coreType); \
+    OP_MEMBER(this,other,auxBasisSet); \
+    OP_MEMBER(this,other,sparseERIIndex); \
+    OP_MEMBER(this,other,scrFileName); \
+    OP_MEMBER(this,other,semiDirectBuffer); \
+    OP_MEMBER(this,other,semiDirectBatches); \
+    OP_MEMBER(this,other,semiDirectCached); \
+    OP_MEMBER(this,other,directTasks); \
+    OP_MEMBER(this,other,directTasksThresh); \
     \
     /* Copy over meta  */ \
     OP_OP(double,this,other,memManager_,schwartz); \
@@ -54,7 +64,9 @@
     OP_VEC_OP(double,this,other,memManager_,coreH); \
     \
     /* 2-e Integrals */ \
-    OP_OP(double,this,other,memManager_,ERI)
+    OP_OP(double,this,other,memManager_,ERI); \
+    OP_OP(double,this,other,memManager_,ERI3J); \
+    OP_OP(double,this,other,memManager_,DFMetric)
 
 
 
@@ -30,6 +30,9 @@
 
 #include <util/threads.hpp>
 
+#include <algorithm>
+#include <future>
+
 // Debug directives
 //#define _DEBUGORTHO
 //#define _DEBUGERI
@@ -416,10 +419,21 @@ namespace ChronusQ {
    *  \brief Allocate, compute and store the full rank-4 ERI tensor using
    *  Libint2 over the CGTO basis. 
    *
-   *  Populates internal AOIntegrals::ERI storage
+   *  Populates internal AOIntegrals::ERI storage. If eriStore == PACKED_ERI,
+   *  only the unique (ij|kl), i>=j, k>=l, ij>=kl are stored
+   *  (see AOIntegrals::packedERIIndex). If eriStore == SPARSE_ERI, see
+   *  AOIntegrals::computeERISparse.
    */ 
   void AOIntegrals::computeERI() {
 
+    CQMemTag memTag(memManager_,"ERI");
+
+    // Screened storage is handled separately
+    if( eriStore == SPARSE_ERI ) {
+      computeERISparse();
+      return;
+    }
+
     // Determine the number of OpenMP threads
     int nthreads = GetNumThreads();
     
@@ -443,15 +457,17 @@ namespace ChronusQ {
     size_t NB3 = NB2*NB;
     size_t NB4 = NB2*NB2;
 
-    try { ERI = memManager_.malloc<double>(NB4); } 
+    size_t ERISize = (eriStore == PACKED_ERI) ? nTT_*(nTT_+1)/2 : NB4;
+
+    try { ERI = memManager_.malloc<double>(ERISize); } 
     catch(...) {
       std::cout << std::fixed;
       std::cout << "Insufficient memory for the full ERI tensor (" 
-                << (NB4/1e9) * sizeof(double) << " GB)" << std::endl;
+                << (ERISize/1e9) * sizeof(double) << " GB)" << std::endl;
       std::cout << std::endl << memManager_ << std::endl;
       CErr();
     }
-    std::fill_n(ERI,NB4,0.);
+    std::fill_n(ERI,ERISize,0.);
 
 
     #pragma omp parallel
@@ -500,6 +516,19 @@ namespace ChronusQ {
         const double *buff = buf_vec[0];
         if(buff == nullptr) continue;
 
+        // Place unique integrals into packed storage
+        if( eriStore == PACKED_ERI ) {
+
+          for(i = 0ul, bf1 = bf1_s, ijkl = 0ul ; i < n1; ++i, bf1++) 
+          for(j = 0ul, bf2 = bf2_s             ; j < n2; ++j, bf2++) 
+          for(k = 0ul, bf3 = bf3_s             ; k < n3; ++k, bf3++) 
+          for(l = 0ul, bf4 = bf4_s             ; l < n4; ++l, bf4++, ++ijkl)
+            ERI[packedERIIndex(bf1,bf2,bf3,bf4)] = buff[ijkl];
+
+          continue;
+
+        }
+
         // Place shell quartet into persistent storage with
         // permutational symmetry
         for(i = 0ul, bf1 = bf1_s, ijkl = 0ul ; i < n1; ++i, bf1++) 
@@ -539,12 +568,563 @@ namespace ChronusQ {
     for(auto k = 0ul; k < NB; k++)
     for(auto l = 0ul; l < NB; l++){
       std::cout << "(" << i << "," << j << "|" << k << "," << l << ")  ";
-      std::cout << ERI[i + j*NB  + k*NB2 + l*NB3] << std::endl;
+      if( eriStore == PACKED_ERI )
+        std::cout << ERI[packedERIIndex(i,j,k,l)] << std::endl;
+      else
+        std::cout << ERI[i + j*NB  + k*NB2 + l*NB3] << std::endl;
     };
 #endif
   }; // AOIntegrals::computeERI
 
 
+
+  /**
+   *  \brief Allocate, compute and store the Schwartz screened rank-4 ERI
+   *  tensor using Libint2 over the CGTO basis.
+   *
+   *  Only the unique shell quartets (s1 s2 | s3 s4), s1>=s2, s3<=s1, 
+   *  s4<=(s1==s3 ? s2 : s3), whose Schwartz bound exceeds threshSchwartz
+   *  are kept. Each surviving (n1 n2 | n3 n4) block is stored contiguously
+   *  in AOIntegrals::ERI (in Libint2 order) and located through
+   *  AOIntegrals::sparseERIIndex.
+   */ 
+  void AOIntegrals::computeERISparse() {
+
+    CQMemTag memTag(memManager_,"ERI");
+
+    const size_t NS = basisSet_.nShell;
+
+    // Determine the surviving shell quartets and their offsets
+    size_t ERISize = computeSparseERIIndex();
+
+    try { ERI = memManager_.malloc<double>(ERISize); } 
+    catch(...) {
+      std::cout << std::fixed;
+      std::cout << "Insufficient memory for the screened ERI tensor (" 
+                << (ERISize/1e9) * sizeof(double) << " GB)" << std::endl;
+      std::cout << std::endl << memManager_ << std::endl;
+      CErr();
+    }
+
+
+    // Determine the number of OpenMP threads
+    int nthreads = GetNumThreads();
+    
+    // Create a vector of libint2::Engines for possible threading
+    std::vector<libint2::Engine> engines(nthreads);
+
+    // Initialize the first engine for the integral evaluation
+    engines[0] = libint2::Engine(libint2::Operator::coulomb,
+      basisSet_.maxPrim,basisSet_.maxL,0);
+    engines[0].set_precision(0.);
+
+    // Copy over the engines to other threads if need be
+    for(size_t i = 1; i < nthreads; i++) engines[i] = engines[0];
+
+
+    #pragma omp parallel
+    {
+      int thread_id = GetThreadID();
+
+      // Get threads result buffer
+      const auto& buf_vec = engines[thread_id].results();
+
+      #pragma omp for schedule(dynamic)
+      for(size_t s1 = 0; s1 < NS; s1++) 
+      for(size_t s2 = 0; s2 <= s1; s2++) {
+
+        size_t n12 = 
+          basisSet_.shells[s1].size() * basisSet_.shells[s2].size();
+
+      for(auto &Q : sparseERIIndex[s1*(s1+1)/2 + s2]) {
+
+        size_t n1234 = n12 * 
+          basisSet_.shells[Q.s3].size() * basisSet_.shells[Q.s4].size();
+
+        // Evaluate ERI for shell quartet
+        engines[thread_id].compute2<
+          libint2::Operator::coulomb, libint2::BraKet::xx_xx, 0>(
+          basisSet_.shells[s1],
+          basisSet_.shells[s2],
+          basisSet_.shells[Q.s3],
+          basisSet_.shells[Q.s4]
+        );
+
+        // Libint2 internal screening
+        const double *buff = buf_vec[0];
+        if(buff == nullptr) std::fill_n(ERI + Q.offset,n1234,0.);
+        else                std::copy_n(buff,n1234,ERI + Q.offset);
+
+      }; // s34
+      }; // s12
+    }; // omp region
+
+  }; // AOIntegrals::computeERISparse
+
+
+
+  /**
+   *  \brief Populate AOIntegrals::sparseERIIndex with the unique shell
+   *  quartets (s1 s2 | s3 s4), s1>=s2, s3<=s1, s4<=(s1==s3 ? s2 : s3),
+   *  whose Schwartz bound exceeds threshSchwartz.
+   *
+   *  Offsets are assigned contiguously in (s1,s2,s3,s4) loop order.
+   *
+   *  \returns The total number of integrals in the surviving quartets
+   */ 
+  size_t AOIntegrals::computeSparseERIIndex() {
+
+    // Compute schwartz bounds if we haven't already
+    if(schwartz == nullptr) computeSchwartz();
+
+    const size_t NS = basisSet_.nShell;
+
+    sparseERIIndex.clear();
+    sparseERIIndex.resize(NS*(NS+1)/2);
+
+    size_t ERISize = 0, nQuartet = 0, nSkip = 0;
+    for(size_t s1(0), s12(0); s1 < NS; s1++) 
+    for(size_t s2(0); s2 <= s1; s2++, s12++) {
+
+      size_t n12 = basisSet_.shells[s1].size() * basisSet_.shells[s2].size();
+      double shz12 = schwartz[s1 + s2*NS];
+
+    for(size_t s3(0); s3 <= s1; s3++) {
+
+      size_t s4_max = (s1 == s3) ? s2 : s3; // Determine the unique max of Shell 4
+
+    for(size_t s4(0); s4 <= s4_max; s4++) {
+
+      if( shz12 * schwartz[s3 + s4*NS] < threshSchwartz ) {
+        nSkip++; continue;
+      }
+
+      sparseERIIndex[s12].push_back({s3,s4,ERISize});
+
+      ERISize += n12 * 
+        basisSet_.shells[s3].size() * basisSet_.shells[s4].size();
+      nQuartet++;
+
+    }
+    }
+    }
+
+#ifdef _REPORT_INTEGRAL_TIMINGS
+    std::cerr << "Sparse ERI: Kept " << nQuartet << " shell quartets ("
+              << ERISize << " integrals), screened " << nSkip << "\n\n";
+#endif
+
+    return ERISize;
+
+  }; // AOIntegrals::computeSparseERIIndex
+
+
+
+
+  /**
+   *  \brief Compute the Schwartz screened rank-4 ERI tensor using Libint2
+   *  over the CGTO basis and stream it to AOIntegrals::scrFileName for the
+   *  SEMIDIRECT contraction algorithm.
+   *
+   *  The surviving shell quartets (see computeSparseERIIndex) are grouped
+   *  into batches of consecutive (s1,s2) shell pairs which hold at most
+   *  semiDirectBuffer integrals (or a single shell pair if larger). Batches
+   *  are evaluated in parallel into one of two buffers while the other is
+   *  being written to disk.
+   *
+   *  Populates AOIntegrals::sparseERIIndex (offsets are relative to the
+   *  start of the file) and AOIntegrals::semiDirectBatches.
+   */ 
+  void AOIntegrals::computeERISemiDirect() {
+
+    CQMemTag memTag(memManager_,"ERI");
+
+    const size_t NS = basisSet_.nShell;
+
+    // Determine the surviving shell quartets and their offsets
+    size_t ERISize = computeSparseERIIndex();
+
+
+    // Map the compound (s1,s2) index to the shell pair
+    std::vector<std::pair<size_t,size_t>> shPairs;
+    for(size_t s1 = 0; s1 < NS; s1++)
+    for(size_t s2 = 0; s2 <= s1; s2++) shPairs.emplace_back(s1,s2);
+
+
+    // Partition the shell pairs into I/O batches
+    semiDirectBatches.clear();
+
+    size_t lenBuffer = 0;
+    for(size_t s12 = 0; s12 < shPairs.size(); s12++) {
+
+      if( sparseERIIndex[s12].empty() ) continue;
+
+      size_t n12 = basisSet_.shells[shPairs[s12].first].size() * 
+                   basisSet_.shells[shPairs[s12].second].size();
+
+      size_t pairSize = 0;
+      for(auto &Q : sparseERIIndex[s12])
+        pairSize += n12 * 
+          basisSet_.shells[Q.s3].size() * basisSet_.shells[Q.s4].size();
+
+      if( semiDirectBatches.empty() or 
+          (semiDirectBatches.back().size + pairSize) > semiDirectBuffer )
+        semiDirectBatches.push_back({s12,s12+1,
+          sparseERIIndex[s12].front().offset,0});
+
+      auto &batch = semiDirectBatches.back();
+      batch.s12End  = s12 + 1;
+      batch.size   += pairSize;
+
+      lenBuffer = std::max(lenBuffer,batch.size);
+
+    }
+
+    // Nothing to cache, all of the shell quartets were screened
+    if( semiDirectBatches.empty() ) {
+      semiDirectCached = true;
+      return;
+    }
+
+    double *ERIBuffer = memManager_.malloc<double>(2*lenBuffer);
+
+
+    // Determine the number of OpenMP threads
+    int nthreads = GetNumThreads();
+    
+    // Create a vector of libint2::Engines for possible threading
+    std::vector<libint2::Engine> engines(nthreads);
+
+    // Initialize the first engine for the integral evaluation
+    engines[0] = libint2::Engine(libint2::Operator::coulomb,
+      basisSet_.maxPrim,basisSet_.maxL,0);
+    engines[0].set_precision(0.);
+
+    // Copy over the engines to other threads if need be
+    for(size_t i = 1; i < nthreads; i++) engines[i] = engines[0];
+
+
+    std::ofstream scrFile(scrFileName,std::ios::binary | std::ios::trunc);
+    if( not scrFile.good() )
+      CErr("Unable to open SEMIDIRECT scratch file " + scrFileName);
+
+    std::future<void> pendingWrite;
+
+    for(size_t iBatch = 0; iBatch < semiDirectBatches.size(); iBatch++) {
+
+      auto &batch = semiDirectBatches[iBatch];
+      double *buffer = ERIBuffer + (iBatch % 2) * lenBuffer;
+
+      #pragma omp parallel
+      {
+        int thread_id = GetThreadID();
+
+        // Get threads result buffer
+        const auto& buf_vec = engines[thread_id].results();
+
+        #pragma omp for schedule(dynamic)
+        for(size_t s12 = batch.s12Start; s12 < batch.s12End; s12++) {
+
+          size_t s1 = shPairs[s12].first;
+          size_t s2 = shPairs[s12].second;
+
+          size_t n12 = 
+            basisSet_.shells[s1].size() * basisSet_.shells[s2].size();
+
+        for(auto &Q : sparseERIIndex[s12]) {
+
+          size_t n1234 = n12 * 
+            basisSet_.shells[Q.s3].size() * basisSet_.shells[Q.s4].size();
+
+          double *ERIQ = buffer + Q.offset - batch.offset;
+
+          // Evaluate ERI for shell quartet
+          engines[thread_id].compute2<
+            libint2::Operator::coulomb, libint2::BraKet::xx_xx, 0>(
+            basisSet_.shells[s1],
+            basisSet_.shells[s2],
+            basisSet_.shells[Q.s3],
+            basisSet_.shells[Q.s4]
+          );
+
+          // Libint2 internal screening
+          const double *buff = buf_vec[0];
+          if(buff == nullptr) std::fill_n(ERIQ,n1234,0.);
+          else                std::copy_n(buff,n1234,ERIQ);
+
+        }; // s34
+        }; // s12
+      }; // omp region
+
+      // Wait for the previous batch to be written before issuing the next
+      if( pendingWrite.valid() ) pendingWrite.get();
+
+      pendingWrite = std::async(std::launch::async,
+        [&scrFile,buffer,batch]() {
+          scrFile.write(reinterpret_cast<const char*>(buffer),
+            batch.size * sizeof(double));
+        });
+
+    }; // loop over batches
+
+    if( pendingWrite.valid() ) pendingWrite.get();
+    scrFile.close();
+
+    if( scrFile.fail() )
+      CErr("Failed to write SEMIDIRECT scratch file " + scrFileName);
+
+    memManager_.free(ERIBuffer);
+
+    semiDirectCached = true;
+
+#ifdef _REPORT_INTEGRAL_TIMINGS
+    std::cerr << "SEMIDIRECT: Wrote " << ERISize << " integrals in " 
+              << semiDirectBatches.size() << " batches to " << scrFileName
+              << "\n\n";
+#endif
+
+  }; // AOIntegrals::computeERISemiDirect
+
+
+
+  /**
+   *  \brief Populate AOIntegrals::directTasks, the work queue for the
+   *  DIRECT ERI contraction (see AOIntegrals::directScaffold).
+   *
+   *  The cost of a shell pair is taken as the number of contracted integrals
+   *  times the number of primitive pairs. The cost of each (s1,s2) task is
+   *  estimated from the unique shell pairs sorted by decreasing Schwartz
+   *  bound: the (s3,s4) which survive the (density independent) Schwartz
+   *  screening are a prefix of that list, whose cumulative cost is found
+   *  by bisection. The prefix is scaled by the fraction of shell pairs
+   *  canonically ordered below (s1,s2) to account for s3 <= s1. Tasks are
+   *  sorted by decreasing cost such that the largest are dispatched first
+   *  and the smallest fill in the tail.
+   */ 
+  void AOIntegrals::computeDirectTasks() {
+
+    // Compute schwartz bounds if we haven't already
+    if(schwartz == nullptr) computeSchwartz();
+
+    const size_t NS    = basisSet_.nShell;
+    const size_t nPair = NS*(NS+1)/2;
+
+    auto pairCost = [&](size_t s1, size_t s2) -> double {
+      return 
+        basisSet_.shells[s1].size()  * basisSet_.shells[s2].size() *
+        basisSet_.shells[s1].nprim() * basisSet_.shells[s2].nprim();
+    };
+
+    // Unique shell pairs sorted by decreasing Schwartz bound
+    std::vector<std::pair<double,double>> shzCost; // (bound, cost)
+    shzCost.reserve(nPair);
+    for(size_t s1 = 0; s1 < NS; s1++) 
+    for(size_t s2 = 0; s2 <= s1; s2++)
+      shzCost.emplace_back(schwartz[s1 + s2*NS],pairCost(s1,s2));
+
+    std::sort(shzCost.begin(),shzCost.end(),
+      [](const std::pair<double,double> &a, 
+         const std::pair<double,double> &b) { return a.first > b.first; });
+
+    // Cumulative cost of the first i pairs
+    std::vector<double> cumCost(nPair+1,0.);
+    for(size_t i = 0; i < nPair; i++)
+      cumCost[i+1] = cumCost[i] + shzCost[i].second;
+
+    directTasks.clear();
+    directTasks.reserve(nPair);
+
+    for(size_t s1 = 0, s12 = 0; s1 < NS; s1++) 
+    for(size_t s2 = 0; s2 <= s1; s2++, s12++) {
+
+      double shz12 = schwartz[s1 + s2*NS];
+
+      // Number of (s3,s4) with shz12 * shz34 >= threshSchwartz
+      size_t nSurv = 
+        std::partition_point(shzCost.begin(),shzCost.end(),
+          [&](const std::pair<double,double> &p) {
+            return shz12 * p.first >= threshSchwartz;
+          }) - shzCost.begin();
+
+      double cost = cumCost[nSurv] * double(s12 + 1) / nPair;
+
+      directTasks.push_back({s1,s2,cost * pairCost(s1,s2)});
+
+    }
+
+    std::stable_sort(directTasks.begin(),directTasks.end(),
+      [](const ERIShellPairTask &a, const ERIShellPairTask &b) {
+        return a.cost > b.cost;
+      });
+
+    directTasksThresh = threshSchwartz;
+
+  }; // AOIntegrals::computeDirectTasks
+
+
+
+  /**
+   *  \brief Allocate, compute and store the rank-3 ERI tensor (mn|P) and
+   *  the Cholesky factorization of the rank-2 metric (P|Q) for the density
+   *  fitted (DENFIT) contraction algorithm using Libint2. P and Q are
+   *  CGTOs in AOIntegrals::auxBasisSet.
+   *
+   *  Populates internal AOIntegrals::ERI3J and AOIntegrals::DFMetric storage.
+   *
+   *  Upon exit DFMetric holds L (lower triangle) such that (P|Q) = L L**T,
+   *  and ERI3J holds the fitted 3-index tensor B(mn,P) = (mn|Q) L**-T(Q,P),
+   *  such that (mn|kl) ~ sum_P B(mn,P) B(kl,P).
+   */
+  void AOIntegrals::computeERI3Index() {
+
+    CQMemTag memTag(memManager_,"ERI");
+
+    if( not auxBasisSet )
+      CErr("Auxiliary basis must be specified for DENFIT integrals");
+
+    BasisSet &auxBasis = *auxBasisSet;
+
+    // Determine the number of OpenMP threads
+    int nthreads = GetNumThreads();
+
+    size_t NB   = basisSet_.nBasis;
+    size_t NB2  = NB*NB;
+    size_t NAux = auxBasis.nBasis;
+
+    if( ERI3J    != nullptr ) memManager_.free(ERI3J);
+    if( DFMetric != nullptr ) memManager_.free(DFMetric);
+
+    try {
+      ERI3J    = memManager_.malloc<double>(NB2*NAux);
+      DFMetric = memManager_.malloc<double>(NAux*NAux);
+    } catch(...) {
+      std::cout << std::fixed;
+      std::cout << "Insufficient memory for the DF ERI tensor ("
+                << (NB2*NAux/1e9) * sizeof(double) << " GB)" << std::endl;
+      std::cout << std::endl << memManager_ << std::endl;
+      CErr();
+    }
+    std::fill_n(ERI3J,NB2*NAux,0.);
+    std::fill_n(DFMetric,NAux*NAux,0.);
+
+    auto topDF = std::chrono::high_resolution_clock::now();
+
+    // Create a vector of libint2::Engines for possible threading
+    std::vector<libint2::Engine> engines3(nthreads), engines2(nthreads);
+
+    engines3[0] = libint2::Engine(libint2::Operator::coulomb,
+      std::max(basisSet_.maxPrim,auxBasis.maxPrim),
+      std::max(basisSet_.maxL,auxBasis.maxL),0);
+    engines3[0].set_precision(0.);
+
+    engines2[0] = engines3[0];
+
+    engines3[0].set(libint2::BraKet::xs_xx);
+    engines2[0].set(libint2::BraKet::xs_xs);
+
+    // Copy over the engines to other threads if need be
+    for(size_t i = 1; i < nthreads; i++) {
+      engines3[i] = engines3[0];
+      engines2[i] = engines2[0];
+    }
+
+    const libint2::Shell unitShell = libint2::Shell::unit();
+
+    #pragma omp parallel
+    {
+      int thread_id = GetThreadID();
+
+      const auto& buf3 = engines3[thread_id].results();
+      const auto& buf2 = engines2[thread_id].results();
+
+      size_t nP,nQ,n1,n2;
+      for(size_t sP(0), bfP_s(0), sPQ(0); sP < auxBasis.nShell;
+          bfP_s += nP, sP++) {
+
+        nP = auxBasis.shells[sP].size(); // Size of Aux Shell P
+
+        // Metric (P|Q), Q <= P
+        for(size_t sQ(0), bfQ_s(0); sQ <= sP; bfQ_s += nQ, sQ++, sPQ++) {
+
+          nQ = auxBasis.shells[sQ].size(); // Size of Aux Shell Q
+
+          // Round Robbin work distribution
+          #ifdef _OPENMP
+          if( sPQ % nthreads != thread_id ) continue;
+          #endif
+
+          engines2[thread_id].compute2<
+            libint2::Operator::coulomb, libint2::BraKet::xs_xs, 0>(
+            auxBasis.shells[sP], unitShell, auxBasis.shells[sQ], unitShell
+          );
+
+          const double *buff = buf2[0];
+          if(buff == nullptr) continue;
+
+          for(size_t p = 0ul, PQ = 0ul; p < nP; p++)
+          for(size_t q = 0ul;           q < nQ; q++, PQ++) {
+            DFMetric[(bfP_s + p) + (bfQ_s + q)*NAux] = buff[PQ];
+            DFMetric[(bfQ_s + q) + (bfP_s + p)*NAux] = buff[PQ];
+          }
+
+        } // sQ
+
+        // 3-index (P|mn), n <= m
+        #ifdef _OPENMP
+        if( sP % nthreads != thread_id ) continue;
+        #endif
+
+        for(size_t s1(0), bf1_s(0); s1 < basisSet_.nShell; bf1_s+=n1, s1++) {
+
+          n1 = basisSet_.shells[s1].size(); // Size of Shell 1
+
+        for(size_t s2(0), bf2_s(0); s2 <= s1; bf2_s+=n2, s2++) {
+
+          n2 = basisSet_.shells[s2].size(); // Size of Shell 2
+
+          engines3[thread_id].compute2<
+            libint2::Operator::coulomb, libint2::BraKet::xs_xx, 0>(
+            auxBasis.shells[sP], unitShell,
+            basisSet_.shells[s1], basisSet_.shells[s2]
+          );
+
+          const double *buff = buf3[0];
+          if(buff == nullptr) continue;
+
+          for(size_t p = 0ul, P12 = 0ul; p < nP; p++) {
+            double *ERI3P = ERI3J + (bfP_s + p)*NB2;
+          for(size_t i = 0ul, bf1 = bf1_s; i < n1; i++, bf1++)
+          for(size_t j = 0ul, bf2 = bf2_s; j < n2; j++, bf2++, P12++) {
+            ERI3P[bf1 + bf2*NB] = buff[P12];
+            ERI3P[bf2 + bf1*NB] = buff[P12];
+          }
+          }
+
+        } // s2
+        } // s1
+      } // sP
+    } // omp region
+
+
+    // Factor the metric (P|Q) = L * L**T
+    int INFO = Cholesky('L',NAux,DFMetric,NAux);
+    if( INFO != 0 )
+      CErr("Cholesky factorization of the DF metric (P|Q) failed");
+
+    // B = (mn|Q) * L**-T
+    Trsm('R','L','T','N',NB2,NAux,1.,DFMetric,NAux,ERI3J,NB2);
+
+    auto botDF = std::chrono::high_resolution_clock::now();
+
+    std::chrono::duration<double> durDF = botDF - topDF;
+
+#ifdef _REPORT_INTEGRAL_TIMINGS
+    std::cerr << "DF ERI evaluation took " << durDF.count() << " s\n\n";
+#endif
+
+  }; // AOIntegrals::computeERI3Index
+
+
   /**
    *  \brief Allocate, compute and store the orthonormalization matricies 
    *  over the CGTO basis.
@@ -740,6 +1320,9 @@ namespace ChronusQ {
 
     if( schwartz != nullptr ) memManager_.free(schwartz);
 
+    // The DIRECT work queue depends on the Schwartz bounds
+    directTasks.clear();
+
     // Allocate the schwartz tensor
     schwartz = memManager_.malloc<double>(basisSet_.nShell*basisSet_.nShell);
 
@@ -0,0 +1,128 @@
+/* 
+ *  This file is part of the Chronus Quantum (ChronusQ) software package
+ *  
+ *  Copyright (C) 2014-2017 Li Research Group (University of Washington)
+ *  
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *  
+ *  Contact the Developers:
+ *    E-Mail: xsli@uw.edu
+ *  
+ */
+#include <aointegrals.hpp>
+#include <cqlinalg/blas3.hpp>
+#include <cqlinalg/blasext.hpp>
+#include <util/threads.hpp>
+
+namespace ChronusQ {
+
+  /**
+   *  \brief Perform a Coulomb-type (34,12) contraction of the density
+   *  fitted ERIs with nCol real matricies stored contiguously in X.
+   *
+   *  AX(mn) = B(mn,P) [ B(kl,P) X(kl) ]
+   *
+   *  \param [in]  nCol Number of matricies to contract
+   *  \param [in]  X    Matricies to contract (NB x NB x nCol)
+   *  \param [out] AX   Contracted matricies (NB x NB x nCol)
+   */ 
+  void AOIntegrals::JContractDenFitReal(size_t nCol, double *X, double *AX) {
+
+    size_t NAux = auxBasisSet->nBasis;
+
+    double *XP = memManager_.malloc<double>(NAux*nCol);
+
+    // XP(P) = B(kl,P) X(kl)
+    Gemm('T','N',NAux,nCol,nSQ_,1.,ERI3J,nSQ_,X,nSQ_,0.,XP,NAux);
+
+    // AX(mn) = B(mn,P) XP(P)
+    Gemm('N','N',nSQ_,nCol,NAux,1.,ERI3J,nSQ_,XP,NAux,0.,AX,nSQ_);
+
+    memManager_.free(XP);
+
+  }; // AOIntegrals::JContractDenFitReal
+
+
+
+  /**
+   *  \brief Perform an Exchange-type (23,12) contraction of the density
+   *  fitted ERIs with nCol real matricies stored contiguously in X.
+   *
+   *  AX(mn) = sum_P B(mk,P) X(kl) B(ln,P)
+   *
+   *  Parallelized over the auxiliary index with thread local
+   *  accumulation.
+   *
+   *  \param [in]  nCol Number of matricies to contract
+   *  \param [in]  X    Matricies to contract (NB x NB x nCol)
+   *  \param [out] AX   Contracted matricies (NB x NB x nCol)
+   */ 
+  void AOIntegrals::KContractDenFitReal(size_t nCol, double *X, double *AX) {
+
+    size_t NB   = basisSet_.nBasis;
+    size_t NAux = auxBasisSet->nBasis;
+
+    size_t nthreads  = GetNumThreads();
+    size_t LAThreads = GetLAThreads();
+    SetLAThreads(1);
+
+    double *SCR = memManager_.malloc<double>(nthreads*nSQ_);
+    double *AXRaw = nullptr;
+    if( nthreads > 1 )
+      AXRaw = memManager_.malloc<double>((nthreads-1)*nCol*nSQ_);
+
+    #pragma omp parallel
+    {
+      size_t thread_id = GetThreadID();
+
+      double *SCR_loc = SCR + thread_id*nSQ_;
+      double *AX_loc  = (thread_id == 0) ? AX : 
+        AXRaw + (thread_id-1)*nCol*nSQ_;
+
+      std::fill_n(AX_loc,nCol*nSQ_,0.);
+
+      #pragma omp for
+      for(size_t P = 0; P < NAux; P++) {
+
+        double *BP = ERI3J + P*nSQ_;
+
+        for(auto iCol = 0; iCol < nCol; iCol++) {
+
+          // SCR(m,l) = B(mk,P) X(kl)
+          Gemm('N','N',NB,NB,NB,1.,BP,NB,X + iCol*nSQ_,NB,0.,SCR_loc,NB);
+
+          // AX(m,n) += SCR(m,l) B(ln,P)
+          Gemm('N','N',NB,NB,NB,1.,SCR_loc,NB,BP,NB,1.,AX_loc + iCol*nSQ_,
+            NB);
+
+        }
+
+      } // loop over P
+
+    } // OpenMP context
+
+    // Reduce the thread local contributions
+    for(auto ithread = 1; ithread < nthreads; ithread++)
+      MatAdd('N','N',nSQ_,nCol,1.,AX,nSQ_,1.,
+        AXRaw + (ithread-1)*nCol*nSQ_,nSQ_,AX,nSQ_);
+
+    memManager_.free(SCR);
+    if( AXRaw != nullptr ) memManager_.free(AXRaw);
+
+    SetLAThreads(LAThreads);
+
+  }; // AOIntegrals::KContractDenFitReal
+
+}; // namespace ChronusQ
@@ -43,6 +43,16 @@ namespace ChronusQ {
   template void AOIntegrals::twoBodyContractDirect(
     std::vector<TwoBodyContraction<dcomplex,dcomplex>> &list);
 
+  template void AOIntegrals::twoBodyContractDenFit(
+    std::vector<TwoBodyContraction<double,double>> &list);
+  template void AOIntegrals::twoBodyContractDenFit(
+    std::vector<TwoBodyContraction<dcomplex,dcomplex>> &list);
+
+  template void AOIntegrals::twoBodyContractSemiDirect(
+    std::vector<TwoBodyContraction<double,double>> &list);
+  template void AOIntegrals::twoBodyContractSemiDirect(
+    std::vector<TwoBodyContraction<dcomplex,dcomplex>> &list);
+
   // Explicit instantiations of orthonormal transformation functions
 
   template void AOIntegrals::Ortho1Trans(double*,double*);
@@ -64,13 +64,38 @@ namespace ChronusQ {
 
     out << std::endl;
     out << "  " << std::setw(28) << "ERI Contraction Algorithm:";
-    if(aoints.cAlg == INCORE) out << "INCORE (Gemm)";
-    else                      out << "DIRECT";
+    if(aoints.cAlg == INCORE)      out << "INCORE (Gemm)";
+    else if(aoints.cAlg == DENFIT) out << "DENFIT (Gemm)";
+    else if(aoints.cAlg == SEMIDIRECT) out << "SEMIDIRECT (Disk Cache)";
+    else                           out << "DIRECT";
     out << std::endl;
 
-    if( aoints.cAlg == DIRECT )
+    if( aoints.cAlg == INCORE ) {
+      out << "    * ERI Storage = ";
+      if(aoints.eriStore == PACKED_ERI) out << "PACKED (8-fold Symmetry)\n";
+      else if(aoints.eriStore == SPARSE_ERI)
+        out << "SPARSE (Schwartz Screened Shell Quartets)\n";
+      else                              out << "DENSE\n";
+    }
+
+    if( aoints.cAlg == INCORE and aoints.eriStore == SPARSE_ERI )
+      out << "    * Schwartz Screening Threshold = " 
+          << aoints.threshSchwartz << "\n";
+
+    if( aoints.cAlg == DENFIT and aoints.auxBasisSet )
+      out << "    * Auxiliary Basis = " << aoints.auxBasisSet->basisName 
+          << " (" << aoints.auxBasisSet->nBasis << " functions)\n";
+
+    if( aoints.cAlg == DIRECT or aoints.cAlg == SEMIDIRECT )
       out << "    * Schwartz Screening Threshold = " 
           << aoints.threshSchwartz << "\n";
+
+    if( aoints.cAlg == SEMIDIRECT ) {
+      out << "    * Scratch File = " << aoints.scrFileName << "\n";
+      out << "    * I/O Buffer Size = " 
+          << aoints.semiDirectBuffer * sizeof(double) / (1024 * 1024) 
+          << " MB\n";
+    }
     
 
     out << std::endl << BannerEnd << std::endl;
@@ -1,12 +1,211 @@
 #include <basisset/basisset_util.hpp>
+#include <cerr.hpp>
 
 // Basis_DEBUG_LEVEL >= 3 - Print EVERYTHING 
 #ifndef Basis_DEBUG_LEVEL
 #  define Basis_DEBUG_LEVEL 0
 #endif
 
+// Number of points evaluated at once (per shell) by the Level 2 evaluation
+#ifndef BASIS_EVAL_BLOCK
+#  define BASIS_EVAL_BLOCK 64
+#endif
+
+// Maximum number of cartesian functions in a shell (L = 6)
+#define BASIS_EVAL_MAXCART 28
+
 namespace ChronusQ {
 
+  /**
+   *  \brief Cartesian exponents (lx,ly,lz) of the functions of a shell of 
+   *  angular momentum L (in the libint2 ordering).
+   */ 
+  template <size_t L>
+  struct CartExponents {
+
+    static constexpr size_t nCart = ((L+1)*(L+2))/2;
+
+    std::array<int,nCart> lx, ly, lz;
+
+    CartExponents() {
+      for(auto i = 0u, I = 0u; i <= L; i++)
+      for(auto j = 0u; j <= i; j++, I++) {
+        lx[I] = L - i;
+        ly[I] = i - j;
+        lz[I] = L - lx[I] - ly[I];
+      }
+    };
+
+  }; // struct CartExponents
+
+
+  /**
+   *  \brief Blocked Basis Set Evaluation Kernel
+   *  Evaluates a single shell (of angular momentum L, known at compile time) 
+   *  over a block of points at once. The coordinates of the points (relative 
+   *  to the shell origin) are passed as structure-of-arrays, and the 
+   *  cartesian monomials are built from tables of the powers of x, y and z.
+   *
+   *  Gives the same values as the Level 3 evaluation.
+   *
+   *   \param [in]  typ   Type of evaluation to perform (gradient, etc)
+   *   \param [in]  shell Shell for evaluation(libint2::Shell).
+   *   \param [in]  n     Number of points (<= BASIS_EVAL_BLOCK)
+   *   \param [in]  X,Y,Z Components of the distances of the points from the shell origin
+   *   \param [in]  RSq   Squared distances of the points from the shell origin
+   *   \param [out] fCar  Cartesian evaluation, f(pt,ixyz,der) with leading 
+   *                      dimension BASIS_EVAL_BLOCK
+   */ 
+  template <size_t L>
+  void evalShellBlock(SHELL_EVAL_TYPE typ, const libint2::Shell &shell, 
+    size_t n, const double *X, const double *Y, const double *Z, 
+    const double *RSq, double *fCar) {
+
+    static const CartExponents<L> cart;
+    constexpr size_t nCart = CartExponents<L>::nCart;
+    constexpr size_t LD    = BASIS_EVAL_BLOCK;
+
+    bool grad = typ == GRADIENT;
+
+    // Contracted radial part (and its derivative factor)
+    alignas(64) double expFactor[LD], alpha[LD];
+    for(auto p = 0ul; p < n; p++) { expFactor[p] = 0.; alpha[p] = 0.; }
+
+    for(auto k = 0ul; k < shell.alpha.size(); k++) {
+      const double c = shell.contr[0].coeff[k];
+      const double a = shell.alpha[k];
+      
+      if( grad ) {
+        #pragma omp simd
+        for(auto p = 0ul; p < n; p++) {
+          double e = std::exp(-a*RSq[p]);
+          expFactor[p] += c * e;
+          alpha[p]     += c * a * e;
+        }
+      } else {
+        #pragma omp simd
+        for(auto p = 0ul; p < n; p++) 
+          expFactor[p] += c * std::exp(-a*RSq[p]);
+      }
+    }
+
+    // Powers of x, y, z up to L+1
+    alignas(64) double xP[L+2][LD], yP[L+2][LD], zP[L+2][LD];
+    for(auto p = 0ul; p < n; p++) { xP[0][p] = 1.; yP[0][p] = 1.; zP[0][p] = 1.; }
+    for(auto l = 1ul; l < L+2; l++)
+    #pragma omp simd
+    for(auto p = 0ul; p < n; p++) {
+      xP[l][p] = xP[l-1][p] * X[p];
+      yP[l][p] = yP[l-1][p] * Y[p];
+      zP[l][p] = zP[l-1][p] * Z[p];
+    }
+
+    double *f  = fCar;
+    double *dx = f  + nCart*LD;
+    double *dy = dx + nCart*LD;
+    double *dz = dy + nCart*LD;
+
+    for(auto I = 0ul; I < nCart; I++) {
+
+      const int lx = cart.lx[I], ly = cart.ly[I], lz = cart.lz[I];
+
+      if( grad ) {
+
+        const double *xm = xP[lx > 0 ? lx-1 : 0];
+        const double *ym = yP[ly > 0 ? ly-1 : 0];
+        const double *zm = zP[lz > 0 ? lz-1 : 0];
+
+        #pragma omp simd
+        for(auto p = 0ul; p < n; p++) {
+          double mon = xP[lx][p] * yP[ly][p] * zP[lz][p];
+          double a2  = 2. * alpha[p];
+          f [I*LD + p] = mon * expFactor[p];
+          dx[I*LD + p] = mon * X[p] * a2 - 
+            lx * expFactor[p] * xm[p] * yP[ly][p] * zP[lz][p];
+          dy[I*LD + p] = mon * Y[p] * a2 - 
+            ly * expFactor[p] * xP[lx][p] * ym[p] * zP[lz][p];
+          dz[I*LD + p] = mon * Z[p] * a2 - 
+            lz * expFactor[p] * xP[lx][p] * yP[ly][p] * zm[p];
+        }
+
+      } else {
+
+        #pragma omp simd
+        for(auto p = 0ul; p < n; p++) 
+          f[I*LD + p] = xP[lx][p] * yP[ly][p] * zP[lz][p] * expFactor[p];
+
+      }
+
+    }
+
+  }; // evalShellBlock
+
+
+  /**
+   *   \brief Blocked Cartesian to Spherical conversion (see CarToSpDEval).
+   *   Transforms (or copies) the cartesian evaluation of a shell over a 
+   *   block of points (as produced by evalShellBlock) into the final storage.
+   *
+   *   \param [in]  typ       Type of evaluation to perform (gradient, etc)
+   *   \param [in]  L         Angular quantum momentum
+   *   \param [in]  n         Number of points in the block
+   *   \param [in]  fCar      Cartesian evaluation, f(pt,ixyz,der)
+   *   \param [out] fEval     Start of the shell / block in the final storage
+   *   \param [in]  NBasisEff Leading dimension of the final storage
+   *   \param [in]  IOff      OffSet of the Gradient components in the final storage
+   *   \param [in]  forceCart True if force cartesian, otherwise sperical evaluation
+   */ 
+  void CarToSpDEvalBlock(SHELL_EVAL_TYPE typ, size_t L, size_t n, 
+    const double *fCar, double *fEval, size_t NBasisEff, size_t IOff, 
+    bool forceCart) {
+
+    constexpr size_t LD = BASIS_EVAL_BLOCK;
+
+    size_t NDer       = (typ == GRADIENT) ? 4 : 1;
+    size_t shSize_car = ((L+1)*(L+2))/2; 
+    size_t shSize_sp  = (2*L+1);
+
+    for(auto iDer = 0ul; iDer < NDer; iDer++) {
+
+      const double *fC = fCar  + iDer*shSize_car*LD;
+      double       *fS = fEval + iDer*IOff;
+
+      // No trasformation needed
+      if( L < 2 or forceCart ) {
+
+        for(auto p = 0ul; p < n; p++)
+        for(auto I = 0ul; I < shSize_car; I++) 
+          fS[I + p*NBasisEff] = fC[I*LD + p];
+
+      // We do transform here
+      } else {
+
+        const double *T = car2sph_matrix[L].data();
+
+        alignas(64) double tmp[LD];
+        for(auto I = 0ul; I < shSize_sp; I++) {
+
+          for(auto p = 0ul; p < n; p++) tmp[p] = 0.;
+
+          for(auto c = 0ul; c < shSize_car; c++) {
+            const double t = T[I*shSize_car + c];
+            if( t == 0. ) continue;
+
+            #pragma omp simd
+            for(auto p = 0ul; p < n; p++) tmp[p] += t * fC[c*LD + p];
+          }
+
+          for(auto p = 0ul; p < n; p++) fS[I + p*NBasisEff] = tmp[p];
+
+        }
+
+      }
+
+    }
+
+  }; // CarToSpDEvalBlock
+
+
   /**
    *  Level 1 Basis Set Evaluation Function (only for debug)
    *  Evaluates a shell set over a specified number of cartesian points.
@@ -72,6 +271,7 @@ namespace ChronusQ {
    *  \brief Level 2 Basis Set Evaluation Function - Used in the KS - DFT
    *  Evaluates a shell set over a specified number of cartesian points. This function requires a precomputed
    *  set of the distances and their x,y,z component for each point from each shell origin in the shells vector.
+   *  Each shell is evaluated over blocks of BASIS_EVAL_BLOCK points at once (see evalShellBlock).
    *  \param [in] typ        Type of evaluation to perform (gradient, etc)
    *  \param [in] shells     Shell set for evaluation(vector of libint2::Shell).
    *  \param [in] evalshells Vector of bool to know if that Shell is relevant  for evaluation.
@@ -101,28 +301,54 @@ namespace ChronusQ {
 
     size_t nShSize = shells.size();
     size_t IOff =  npts*NBasisEff;
-    std::array<double,3> rVal;
 
-    for (auto ipts = 0ul; ipts < npts; ipts++){
-      size_t Ic = 0;
+    // Structure-of-arrays block scratch
+    alignas(64) double X[BASIS_EVAL_BLOCK], Y[BASIS_EVAL_BLOCK], 
+      Z[BASIS_EVAL_BLOCK], RSq[BASIS_EVAL_BLOCK];
+    alignas(64) double fCar[4*BASIS_EVAL_MAXCART*BASIS_EVAL_BLOCK];
+
+    size_t Ic = 0;
     for (auto iSh = 0ul; iSh < nShSize; iSh++){
-      if(evalShell[iSh]) {
-        double * fStart    = fEval + Ic + ipts*NBasisEff;
 
-        rVal [0]= r[0 + mapSh2Cen[iSh]*3 + ipts*3*nCenter];
-        rVal [1]= r[1 + mapSh2Cen[iSh]*3 + ipts*3*nCenter];
-        rVal [2]= r[2 + mapSh2Cen[iSh]*3 + ipts*3*nCenter];
+      if( not evalShell[iSh] ) continue;
 
-        evalShellSet(typ,shells[iSh],rSq[mapSh2Cen[iSh] + ipts*nCenter],
-          rVal,SCR,IOffSCR); 
+      const libint2::Shell &shell = shells[iSh];
+      size_t L   = shell.contr[0].l;
+      size_t cen = mapSh2Cen[iSh];
 
-        CarToSpDEval(typ, shells[iSh].contr[0].l, SCR, fStart, IOff, IOffSCR, forceCart);
+      for (auto p0 = 0ul; p0 < npts; p0 += BASIS_EVAL_BLOCK) {
 
-        Ic += shells[iSh].size(); // Increment offset in basis
-      }
+        size_t n = std::min(size_t(BASIS_EVAL_BLOCK), npts - p0);
+
+        // Gather the distances of the block of points
+        for (auto p = 0ul; p < n; p++) {
+          const double *rPt = r + cen*3 + (p0 + p)*3*nCenter;
+          X[p]   = rPt[0];
+          Y[p]   = rPt[1];
+          Z[p]   = rPt[2];
+          RSq[p] = rSq[cen + (p0 + p)*nCenter];
+        }
+
+        switch(L) {
+          case 0: evalShellBlock<0>(typ,shell,n,X,Y,Z,RSq,fCar); break;
+          case 1: evalShellBlock<1>(typ,shell,n,X,Y,Z,RSq,fCar); break;
+          case 2: evalShellBlock<2>(typ,shell,n,X,Y,Z,RSq,fCar); break;
+          case 3: evalShellBlock<3>(typ,shell,n,X,Y,Z,RSq,fCar); break;
+          case 4: evalShellBlock<4>(typ,shell,n,X,Y,Z,RSq,fCar); break;
+          case 5: evalShellBlock<5>(typ,shell,n,X,Y,Z,RSq,fCar); break;
+          case 6: evalShellBlock<6>(typ,shell,n,X,Y,Z,RSq,fCar); break;
+          default: 
+            CErr("Basis evaluation only implemented up to L = 6");
+        }
+
+        CarToSpDEvalBlock(typ,L,n,fCar,fEval + Ic + p0*NBasisEff,NBasisEff,
+          IOff,forceCart);
+
+      } // loop over blocks of points
+
+      Ic += shell.size(); // Increment offset in basis
 
     } // loop over shells
-    } // loop over points
 
   }; // evalShellSet Level 2
 
@@ -84,6 +84,31 @@ namespace ChronusQ {
 
   }; // GEMM (real,complex,complex)
 
+  template<>
+  void Trsm(char SIDE, char UPLO, char TRANSA, char DIAG, int M, int N,
+    double ALPHA, double *A, int LDA, double *B, int LDB) {
+#ifdef _CQ_MKL
+    dtrsm
+#else
+    dtrsm_
+#endif
+    (&SIDE,&UPLO,&TRANSA,&DIAG,&M,&N,&ALPHA,A,&LDA,B,&LDB);
+
+  }; // TRSM (real)
+
+
+  template<>
+  void Trsm(char SIDE, char UPLO, char TRANSA, char DIAG, int M, int N,
+    dcomplex ALPHA, dcomplex *A, int LDA, dcomplex *B, int LDB) {
+#ifdef _CQ_MKL
+    ztrsm(&SIDE,&UPLO,&TRANSA,&DIAG,&M,&N,&ALPHA,A,&LDA,B,&LDB);
+#else
+    ztrsm_(&SIDE,&UPLO,&TRANSA,&DIAG,&M,&N,reinterpret_cast<double*>(&ALPHA),
+      reinterpret_cast<double*>(A),&LDA,reinterpret_cast<double*>(B),&LDB);
+#endif
+
+  }; // TRSM (complex)
+
   /*
    *  performs one of the symmetric rank 2k operations
    *  C := alpha*A*B' + alpha*B*A' + beta*C
@@ -24,6 +24,9 @@
 #include <cqlinalg/eig.hpp>
 #include <cqlinalg/util.hpp>
 
+#include <map>
+#include <mutex>
+
 namespace ChronusQ {
 
   /**
@@ -433,6 +436,41 @@ namespace ChronusQ {
 
   /** LAPACK Wrappers **/
 
+  /**
+   *  \brief Cache of the optimal LAPACK workspace dimensions.
+   *
+   *  The workspace query is only performed the first time a routine
+   *  is called for a particular problem. The key is made of the routine
+   *  name, the problem dimension and the job specification.
+   *
+   *  \param [in] key   Key for the workspace query
+   *  \param [in] query Function which returns the optimal workspace
+   *                    dimensions
+   *  \returns          Optimal workspace dimensions
+   */ 
+  typedef std::tuple<std::string,int,char,char> LWorkKey;
+  typedef std::array<int,3> LWorkVal;
+
+  LWorkVal cachedLWork(const LWorkKey &key, 
+    const std::function<LWorkVal()> &query) {
+
+    static std::map<LWorkKey,LWorkVal> cache;
+    static std::mutex cacheLock;
+
+    {
+      std::lock_guard<std::mutex> lck(cacheLock);
+      auto it = cache.find(key);
+      if( it != cache.end() ) return it->second;
+    }
+
+    LWorkVal LWORK = query();
+
+    std::lock_guard<std::mutex> lck(cacheLock);
+    cache[key] = LWORK;
+    return LWORK;
+
+  }; // cachedLWork
+
   /**
    *  \brief Wrapper around LAPACK's DGEEV.
    *
@@ -481,7 +519,8 @@ namespace ChronusQ {
     auto test = std::bind(dsyev_,&JOBZ,&UPLO,&N,A,&LDA,W,std::placeholders::_1,
       std::placeholders::_2,&INFO);
   
-    int LWORK = getLWork<double>(test);
+    int LWORK = cachedLWork(LWorkKey("DSYEV",N,JOBZ,'A'),
+      [&]() -> LWorkVal { return {getLWork<double>(test),0,0}; })[0];
     double *WORK = mem.malloc<double>(LWORK);
   
     dsyev_(&JOBZ,&UPLO,&N,A,&LDA,W,WORK,&LWORK,&INFO);
@@ -492,6 +531,75 @@ namespace ChronusQ {
   }; // DSYEV
   
   
+  /**
+   *  \brief Wrapper around LAPACK's DSYEVD.
+   *
+   *  Wraps DSYEVD to obtain the optimal workspace dimensions and allocation.
+   *  Passes CQMemManager object to handle memory allocation / deallocation.
+   *
+   *  See http://www.netlib.org/lapack/explore-html/d2/d8a/group__double_s_yeigen.html
+   *  for parameter documentation.
+   */ 
+  int DSYEVD(char JOBZ, char UPLO, int N, double *A, int LDA, double *W,
+    CQMemManager &mem) {
+  
+    int INFO;
+  
+    LWorkVal LWORK = cachedLWork(LWorkKey("DSYEVD",N,JOBZ,'A'),
+      [&]() -> LWorkVal {
+        int LWORKQ = -1; double WORKQ; int IWORKQ;
+        dsyevd_(&JOBZ,&UPLO,&N,A,&LDA,W,&WORKQ,&LWORKQ,&IWORKQ,&LWORKQ,&INFO);
+        return {int(WORKQ),IWORKQ,0};
+      });
+
+    double *WORK  = mem.malloc<double>(LWORK[0]);
+    int    *IWORK = mem.malloc<int>(LWORK[1]);
+  
+    dsyevd_(&JOBZ,&UPLO,&N,A,&LDA,W,WORK,&LWORK[0],IWORK,&LWORK[1],&INFO);
+  
+    mem.free(WORK,IWORK);
+    
+    return INFO;
+  }; // DSYEVD
+
+
+  /**
+   *  \brief Wrapper around LAPACK's DSYEVR.
+   *
+   *  Wraps DSYEVR to obtain the optimal workspace dimensions and allocation.
+   *  Passes CQMemManager object to handle memory allocation / deallocation.
+   *
+   *  See http://www.netlib.org/lapack/explore-html/d2/d8a/group__double_s_yeigen.html
+   *  for parameter documentation.
+   */ 
+  int DSYEVR(char JOBZ, char RANGE, char UPLO, int N, double *A, int LDA, 
+    double VL, double VU, int IL, int IU, int &M, double *W, double *Z, 
+    int LDZ, CQMemManager &mem) {
+  
+    int INFO;
+    double ABSTOL = 0.;
+    int *ISUPPZ = mem.malloc<int>(2*N);
+  
+    LWorkVal LWORK = cachedLWork(LWorkKey("DSYEVR",N,JOBZ,RANGE),
+      [&]() -> LWorkVal {
+        int LWORKQ = -1; double WORKQ; int IWORKQ;
+        dsyevr_(&JOBZ,&RANGE,&UPLO,&N,A,&LDA,&VL,&VU,&IL,&IU,&ABSTOL,&M,W,Z,
+          &LDZ,ISUPPZ,&WORKQ,&LWORKQ,&IWORKQ,&LWORKQ,&INFO);
+        return {int(WORKQ),IWORKQ,0};
+      });
+
+    double *WORK  = mem.malloc<double>(LWORK[0]);
+    int    *IWORK = mem.malloc<int>(LWORK[1]);
+  
+    dsyevr_(&JOBZ,&RANGE,&UPLO,&N,A,&LDA,&VL,&VU,&IL,&IU,&ABSTOL,&M,W,Z,
+      &LDZ,ISUPPZ,WORK,&LWORK[0],IWORK,&LWORK[1],&INFO);
+  
+    mem.free(WORK,IWORK,ISUPPZ);
+    
+    return INFO;
+  }; // DSYEVR
+  
+  
   /**
    *  \brief Wrapper around LAPACK's DGGEV.
    *
@@ -572,7 +680,8 @@ namespace ChronusQ {
     auto test = std::bind(zheev_,&JOBZ,&UPLO,&N,A,&LDA,W,
       std::placeholders::_1,std::placeholders::_2,RWORK,&INFO);
   
-    int LWORK = getLWork<dcomplex>(test);
+    int LWORK = cachedLWork(LWorkKey("ZHEEV",N,JOBZ,'A'),
+      [&]() -> LWorkVal { return {getLWork<dcomplex>(test),0,0}; })[0];
     dcomplex *WORK = mem.malloc<dcomplex>(LWORK);
   
     zheev_(&JOBZ,&UPLO,&N,A,&LDA,W,WORK,&LWORK,RWORK,&INFO);
@@ -583,6 +692,78 @@ namespace ChronusQ {
     return INFO;
   }; // ZHEEV
   
+  /**
+   *  \brief Wrapper around LAPACK's ZHEEVD.
+   *
+   *  Wraps ZHEEVD to obtain the optimal workspace dimensions and allocation.
+   *  Passes CQMemManager object to handle memory allocation / deallocation.
+   *
+   *  See http://www.netlib.org/lapack/explore-html/df/d9a/group__complex16_h_eeigen.html
+   *  for parameter documentation.
+   */ 
+  int ZHEEVD(char JOBZ, char UPLO, int N, dcomplex *A, int LDA, double *W,
+    CQMemManager &mem) {
+  
+    int INFO;
+  
+    LWorkVal LWORK = cachedLWork(LWorkKey("ZHEEVD",N,JOBZ,'A'),
+      [&]() -> LWorkVal {
+        int LWORKQ = -1; dcomplex WORKQ; double RWORKQ; int IWORKQ;
+        zheevd_(&JOBZ,&UPLO,&N,A,&LDA,W,&WORKQ,&LWORKQ,&RWORKQ,&LWORKQ,
+          &IWORKQ,&LWORKQ,&INFO);
+        return {int(std::real(WORKQ)),int(RWORKQ),IWORKQ};
+      });
+
+    dcomplex *WORK  = mem.malloc<dcomplex>(LWORK[0]);
+    double   *RWORK = mem.malloc<double>(LWORK[1]);
+    int      *IWORK = mem.malloc<int>(LWORK[2]);
+  
+    zheevd_(&JOBZ,&UPLO,&N,A,&LDA,W,WORK,&LWORK[0],RWORK,&LWORK[1],IWORK,
+      &LWORK[2],&INFO);
+  
+    mem.free(WORK,RWORK,IWORK);
+    
+    return INFO;
+  }; // ZHEEVD
+
+
+  /**
+   *  \brief Wrapper around LAPACK's ZHEEVR.
+   *
+   *  Wraps ZHEEVR to obtain the optimal workspace dimensions and allocation.
+   *  Passes CQMemManager object to handle memory allocation / deallocation.
+   *
+   *  See http://www.netlib.org/lapack/explore-html/df/d9a/group__complex16_h_eeigen.html
+   *  for parameter documentation.
+   */ 
+  int ZHEEVR(char JOBZ, char RANGE, char UPLO, int N, dcomplex *A, int LDA, 
+    double VL, double VU, int IL, int IU, int &M, double *W, dcomplex *Z, 
+    int LDZ, CQMemManager &mem) {
+  
+    int INFO;
+    double ABSTOL = 0.;
+    int *ISUPPZ = mem.malloc<int>(2*N);
+  
+    LWorkVal LWORK = cachedLWork(LWorkKey("ZHEEVR",N,JOBZ,RANGE),
+      [&]() -> LWorkVal {
+        int LWORKQ = -1; dcomplex WORKQ; double RWORKQ; int IWORKQ;
+        zheevr_(&JOBZ,&RANGE,&UPLO,&N,A,&LDA,&VL,&VU,&IL,&IU,&ABSTOL,&M,W,Z,
+          &LDZ,ISUPPZ,&WORKQ,&LWORKQ,&RWORKQ,&LWORKQ,&IWORKQ,&LWORKQ,&INFO);
+        return {int(std::real(WORKQ)),int(RWORKQ),IWORKQ};
+      });
+
+    dcomplex *WORK  = mem.malloc<dcomplex>(LWORK[0]);
+    double   *RWORK = mem.malloc<double>(LWORK[1]);
+    int      *IWORK = mem.malloc<int>(LWORK[2]);
+  
+    zheevr_(&JOBZ,&RANGE,&UPLO,&N,A,&LDA,&VL,&VU,&IL,&IU,&ABSTOL,&M,W,Z,
+      &LDZ,ISUPPZ,WORK,&LWORK[0],RWORK,&LWORK[1],IWORK,&LWORK[2],&INFO);
+  
+    mem.free(WORK,RWORK,IWORK,ISUPPZ);
+    
+    return INFO;
+  }; // ZHEEVR
+  
   /**
    *  \brief Wrapper around LAPACK's ZGGEV.
    *
@@ -712,6 +893,88 @@ namespace ChronusQ {
     return INFO;
   
   }; // HermetianEigen (complex / complex eigenvalues )
+
+  template<>
+  int HermetianEigen(HERMETIAN_EIGEN_ALG ALG, char JOBZ, char UPLO, int N, 
+    double *A, int LDA, double *W, CQMemManager &mem){
+
+    if( ALG == DC_EIGEN ) return DSYEVD(JOBZ,UPLO,N,A,LDA,W,mem);
+    else if( ALG == MRRR_EIGEN ) {
+
+      int M;
+      double *Z = (JOBZ == 'V') ? mem.malloc<double>(N*N) : nullptr;
+      int INFO = DSYEVR(JOBZ,'A',UPLO,N,A,LDA,0.,0.,0,0,M,W,Z,N,mem);
+
+      if( JOBZ == 'V' ) {
+        for(auto j = 0; j < N; j++) std::copy_n(Z + j*N,N,A + j*LDA);
+        mem.free(Z);
+      }
+
+      return INFO;
+
+    } else return DSYEV(JOBZ,UPLO,N,A,LDA,W,mem);
+
+  }; // HermetianEigen (real / real eigenvalues / selectable backend)
+
+  template<>
+  int HermetianEigen(HERMETIAN_EIGEN_ALG ALG, char JOBZ, char UPLO, int N, 
+    dcomplex *A, int LDA, double *W, CQMemManager &mem){
+
+    if( ALG == DC_EIGEN ) return ZHEEVD(JOBZ,UPLO,N,A,LDA,W,mem);
+    else if( ALG == MRRR_EIGEN ) {
+
+      int M;
+      dcomplex *Z = (JOBZ == 'V') ? mem.malloc<dcomplex>(N*N) : nullptr;
+      int INFO = ZHEEVR(JOBZ,'A',UPLO,N,A,LDA,0.,0.,0,0,M,W,Z,N,mem);
+
+      if( JOBZ == 'V' ) {
+        for(auto j = 0; j < N; j++) std::copy_n(Z + j*N,N,A + j*LDA);
+        mem.free(Z);
+      }
+
+      return INFO;
+
+    } else return ZHEEV(JOBZ,UPLO,N,A,LDA,W,mem);
+
+  }; // HermetianEigen (complex / real eigenvalues / selectable backend)
+
+  template<>
+  int HermetianEigen(char JOBZ, char UPLO, int N, int NEIG, double *A, 
+    int LDA, double *W, CQMemManager &mem){
+
+    if( NEIG >= N ) return HermetianEigen(MRRR_EIGEN,JOBZ,UPLO,N,A,LDA,W,mem);
+
+    int M;
+    double *Z = (JOBZ == 'V') ? mem.malloc<double>(N*NEIG) : nullptr;
+    int INFO = DSYEVR(JOBZ,'I',UPLO,N,A,LDA,0.,0.,1,NEIG,M,W,Z,N,mem);
+
+    if( JOBZ == 'V' ) {
+      for(auto j = 0; j < NEIG; j++) std::copy_n(Z + j*N,N,A + j*LDA);
+      mem.free(Z);
+    }
+
+    return INFO;
+
+  }; // HermetianEigen (real / real eigenvalues / partial spectrum)
+
+  template<>
+  int HermetianEigen(char JOBZ, char UPLO, int N, int NEIG, dcomplex *A, 
+    int LDA, double *W, CQMemManager &mem){
+
+    if( NEIG >= N ) return HermetianEigen(MRRR_EIGEN,JOBZ,UPLO,N,A,LDA,W,mem);
+
+    int M;
+    dcomplex *Z = (JOBZ == 'V') ? mem.malloc<dcomplex>(N*NEIG) : nullptr;
+    int INFO = ZHEEVR(JOBZ,'I',UPLO,N,A,LDA,0.,0.,1,NEIG,M,W,Z,N,mem);
+
+    if( JOBZ == 'V' ) {
+      for(auto j = 0; j < NEIG; j++) std::copy_n(Z + j*N,N,A + j*LDA);
+      mem.free(Z);
+    }
+
+    return INFO;
+
+  }; // HermetianEigen (complex / real eigenvalues / partial spectrum)
   
   template <>
   int GeneralizedEigen(char JOBVL, char JOBVR, int N, double *A, int LDA, 
@@ -77,6 +77,286 @@ namespace ChronusQ {
   };
 
 
+  inline double ReConjProd(double x, double y) { return x*y; }
+  inline double ReConjProd(dcomplex x, dcomplex y) { 
+    return std::real(x*std::conj(y)); 
+  }
+
+  /**
+   *  \brief Computes Tr[A * B] for hermetian A and B in O(N^2)
+   */ 
+  template <typename _F>
+  double HerTraceProd(size_t N, const _F *A, size_t LDA, const _F *B, 
+    size_t LDB) {
+
+    double tr = 0.;
+    for(size_t j = 0; j < N; j++)
+    for(size_t i = 0; i < N; i++)
+      tr += ReConjProd(A[i + j*LDA],B[i + j*LDB]);
+
+    return tr;
+
+  };
+
+  /**
+   *  \brief Computes the trace of a matrix
+   */ 
+  template <typename _F>
+  double Trace(size_t N, const _F *A, size_t LDA) {
+
+    double tr = 0.;
+    for(size_t i = 0; i < N; i++) tr += std::real(A[i*(LDA+1)]);
+    return tr;
+
+  };
+
+
+  /**
+   *  \brief Obtain the density matrix (projector onto the NOCC lowest
+   *  eigenvectors) of a hermetian matrix F without diagonalization.
+   *
+   *  Only makes use of matrix multiplications (2 Gemm per iteration).
+   *  The spectral bounds of F are obtained from the Gershgorin circles. 
+   *
+   *  CANONICAL_PURIFICATION: A. H. R. Palser and D. E. Manolopoulos, 
+   *    Phys. Rev. B 58, 12704 (1998)
+   *
+   *  TRS4_PURIFICATION: A. M. N. Niklasson, C. J. Tymczak and M. Challacombe,
+   *    J. Chem. Phys. 118, 8611 (2003)
+   *
+   *  Iterates until Tr[P - P**2] < TOL (or stagnates at the round-off
+   *  level).
+   *
+   *  \param [in]  ALG      Purification scheme
+   *  \param [in]  N        Dimension of F
+   *  \param [in]  NOCC     Number of occupied states
+   *  \param [in]  F        Hermetian matrix
+   *  \param [in]  LDF      Leading dimension of F
+   *  \param [out] P        Density matrix
+   *  \param [in]  LDP      Leading dimension of P
+   *  \param [in]  TOL      Convergence tolerance
+   *  \param [in]  MAXITER  Maximum number of iterations
+   *  \param [in]  SCR      Scratch space (2 x N x N)
+   *
+   *  \returns The number of iterations, -1 if the purification failed to
+   *  converge (e.g. no HOMO-LUMO gap).
+   */ 
+  template <typename _F>
+  int Purify(PURIFICATION_ALG ALG, size_t N, size_t NOCC, _F *F, size_t LDF,
+    _F *P, size_t LDP, double TOL, size_t MAXITER, _F *SCR) {
+
+    // Trivial cases
+    if( NOCC == 0 or NOCC >= N ) {
+      for(size_t j = 0; j < N; j++)
+      for(size_t i = 0; i < N; i++)
+        P[i + j*LDP] = (i == j and NOCC != 0) ? 1. : 0.;
+      return 0;
+    }
+
+    // Gershgorin bounds of the spectrum of F
+    double eMin = std::numeric_limits<double>::infinity();
+    double eMax = -eMin;
+    for(size_t i = 0; i < N; i++) {
+      double R = 0.;
+      for(size_t j = 0; j < N; j++) 
+        if( j != i ) R += std::abs(F[i + j*LDF]);
+
+      eMin = std::min(eMin, std::real(F[i*(LDF+1)]) - R);
+      eMax = std::max(eMax, std::real(F[i*(LDF+1)]) + R);
+    }
+
+    _F* P2  = SCR + N*N;
+
+    double theta = double(NOCC) / N;
+
+    // Initial guess (spectrum of F mapped into [0,1], reversed)
+    if( ALG == CANONICAL_PURIFICATION ) {
+
+      double mu  = Trace(N,F,LDF) / N;
+      double lam = std::min(theta / (eMax - mu), (1. - theta) / (mu - eMin));
+
+      for(size_t j = 0; j < N; j++)
+      for(size_t i = 0; i < N; i++)
+        P[i + j*LDP] = -lam * F[i + j*LDF];
+
+      for(size_t i = 0; i < N; i++) P[i*(LDP+1)] += lam * mu + theta;
+
+    } else {
+
+      double fact = 1. / (eMax - eMin);
+
+      for(size_t j = 0; j < N; j++)
+      for(size_t i = 0; i < N; i++)
+        P[i + j*LDP] = -fact * F[i + j*LDF];
+
+      for(size_t i = 0; i < N; i++) P[i*(LDP+1)] += fact * eMax;
+
+    }
+
+    size_t iter    = 0;
+    double errPrev = std::numeric_limits<double>::infinity();
+    bool   conv    = false;
+
+    for(; iter < MAXITER; iter++) {
+
+      // P2 = P * P
+      Gemm('N','N',N,N,N,_F(1.),P,LDP,P,LDP,_F(0.),P2,N);
+
+      double trP  = Trace(N,P,LDP);
+      double trP2 = Trace(N,P2,N);
+
+      // Idempotency error: Tr[P - P**2] = sum n (1 - n)
+      double err = std::abs(trP - trP2);
+      if( err < TOL or (err >= errPrev and errPrev < std::sqrt(TOL)) ) {
+        conv = true; break;
+      }
+      errPrev = err;
+
+      // Tr[P**3], Tr[P**4]
+      double trP3 = HerTraceProd(N,P2,N,P,LDP);
+      double trP4 = HerTraceProd(N,P2,N,P2,N);
+
+      // P <- P2 * (a P + b P2 + c I) + d P
+      double a, b, c, d = 0.;
+      if( ALG == CANONICAL_PURIFICATION ) {
+
+        double cn = (trP2 - trP3) / (trP - trP2);
+        if( cn < 0. or cn > 1. ) break;
+
+        if( cn >= 0.5 ) { 
+          // P = ((1+cn) P2 - P3) / cn
+          a = -1. / cn; b = 0.; c = (1. + cn) / cn; 
+        } else {
+          // P = ((1-2cn) P + (1+cn) P2 - P3) / (1-cn)
+          a = -1. / (1. - cn); b = 0.; c = (1. + cn) / (1. - cn);
+          d = (1. - 2.*cn) / (1. - cn);
+        }
+
+      } else {
+
+        // TRS4
+        //   F(P) = P2 (4 P - 3 P2), G(P) = P2 (I - P)**2
+        double trF = 4.*trP3 - 3.*trP4;
+        double trG = trP2 - 2.*trP3 + trP4;
+        double gam = (trG > 0.) ? (NOCC - trF) / trG : 0.;
+
+        if( gam > 6. ) {
+          // P = 2P - P2
+          a = 0.; b = 0.; c = -1.; d = 2.;
+        } else if( gam < 0. ) {
+          // P = P2
+          a = 0.; b = 0.; c = 1.;
+        } else {
+          // P = F(P) + gam G(P) = P2 ((4 - 2gam) P + (gam - 3) P2 + gam I)
+          a = 4. - 2.*gam; b = gam - 3.; c = gam;
+        }
+
+      }
+
+      if( a == 0. and b == 0. ) {
+
+        for(size_t j = 0; j < N; j++)
+        for(size_t i = 0; i < N; i++)
+          P[i + j*LDP] = c * P2[i + j*N] + d * P[i + j*LDP];
+
+      } else {
+
+        for(size_t j = 0; j < N; j++)
+        for(size_t i = 0; i < N; i++) {
+          SCR[i + j*N] = a * P[i + j*LDP] + b * P2[i + j*N];
+          if( i == j ) SCR[i + j*N] += c;
+        }
+
+        Gemm('N','N',N,N,N,_F(1.),P2,N,SCR,N,_F(d),P,LDP);
+
+      }
+
+    }
+
+    return conv ? int(iter) : -1;
+
+  }; // Purify
+
+  /**
+   *  \brief Computes the exponential of a general matrix, exp(A), by 
+   *  scaling and squaring of its Taylor series.
+   *
+   *  Unlike MatExp, A need not be hermetian (e.g. the real anti-symmetric
+   *  generators of orbital rotations). Only makes use of matrix 
+   *  multiplications, efficient for small |A|.
+   *
+   *  \param [in]  N      Dimension of A
+   *  \param [in]  A      Matrix to exponentiate
+   *  \param [in]  LDA    Leading dimension of A
+   *  \param [out] ExpA   exp(A)
+   *  \param [in]  LDEXPA Leading dimension of ExpA
+   *  \param [in]  mem    Memory manager
+   */ 
+  template <typename _F>
+  void MatExpTaylor(size_t N, _F *A, size_t LDA, _F *ExpA, size_t LDEXPA,
+    CQMemManager &mem) {
+
+    // Scale A such that |A / 2**s| <= 0.5
+    double nrmA = 0.;
+    for(auto j = 0; j < N; j++)
+    for(auto i = 0; i < N; i++) nrmA += std::norm(A[i + j*LDA]);
+    nrmA = std::sqrt(nrmA);
+
+    int nSq = (nrmA > 0.5) ? int(std::ceil(std::log2(nrmA / 0.5))) : 0;
+    double scale = std::pow(2.,-nSq);
+
+    _F* X   = mem.malloc<_F>(N*N);
+    _F* SCR = mem.malloc<_F>(N*N);
+
+    // X = A / 2**s, exp(A / 2**s) = I + X + ...
+    for(auto j = 0; j < N; j++)
+    for(auto i = 0; i < N; i++) {
+      X[i + j*N] = scale * A[i + j*LDA];
+      ExpA[i + j*LDEXPA] = X[i + j*N];
+      if( i == j ) ExpA[i + j*LDEXPA] += 1.;
+    }
+
+    // X <- (A / 2**s) X / k
+    for(auto k = 2; k < 30; k++) {
+
+      Gemm('N','N',N,N,N,_F(scale / k),A,LDA,X,N,_F(0.),SCR,N);
+      std::swap(X,SCR);
+
+      double nrmX = 0.;
+      for(auto j = 0; j < N; j++)
+      for(auto i = 0; i < N; i++) {
+        ExpA[i + j*LDEXPA] += X[i + j*N];
+        nrmX += std::norm(X[i + j*N]);
+      }
+
+      if( std::sqrt(nrmX) < std::numeric_limits<double>::epsilon() ) break;
+
+    }
+
+    // exp(A) = exp(A / 2**s)**(2**s)
+    for(auto iSq = 0; iSq < nSq; iSq++) {
+
+      Gemm('N','N',N,N,N,_F(1.),ExpA,LDEXPA,ExpA,LDEXPA,_F(0.),SCR,N);
+
+      for(auto j = 0; j < N; j++)
+        std::copy_n(SCR + j*N,N,ExpA + j*LDEXPA);
+
+    }
+
+    mem.free(X,SCR);
+
+  }; // MatExpTaylor
+
+  template int Purify(PURIFICATION_ALG,size_t,size_t,double*,size_t,double*,
+    size_t,double,size_t,double*);
+  template int Purify(PURIFICATION_ALG,size_t,size_t,dcomplex*,size_t,
+    dcomplex*,size_t,double,size_t,dcomplex*);
+
+  template void MatExpTaylor(size_t,double*,size_t,double*,size_t,
+    CQMemManager&);
+  template void MatExpTaylor(size_t,dcomplex*,size_t,dcomplex*,size_t,
+    CQMemManager&);
+
 //template void MatExp(char,size_t,double,double*,size_t,double*,size_t,
 //  CQMemManager&);
 
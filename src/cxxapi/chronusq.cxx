@@ -50,6 +50,7 @@ int main(int argc, char *argv[]) {
 
     outFileName = tokens[0] + ".out";
     rstFileName = tokens[0] + ".bin";
+    scrFileName = tokens[0] + ".scr";
 
   // FIXME: Need to fix this for generality in specification
   } else { // Variable Argc
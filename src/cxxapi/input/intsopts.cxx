@@ -47,9 +47,58 @@ namespace ChronusQ {
       aoi.cAlg = CONTRACTION_ALGORITHM::DIRECT;
     else if( not ALG.compare("INCORE") )
       aoi.cAlg = CONTRACTION_ALGORITHM::INCORE;
+    else if( not ALG.compare("DENFIT") )
+      aoi.cAlg = CONTRACTION_ALGORITHM::DENFIT;
+    else if( not ALG.compare("SEMIDIRECT") )
+      aoi.cAlg = CONTRACTION_ALGORITHM::SEMIDIRECT;
     else
       CErr(ALG + "not a valid INTS.ALG",out);
 
+
+    // Parse INCORE ERI storage scheme
+    std::string ERISTORE = "DENSE";
+    OPTOPT( ERISTORE = input.getData<std::string>("INTS.ERISTORE"); )
+    trim(ERISTORE);
+
+    if( not ERISTORE.compare("DENSE") )
+      aoi.eriStore = ERI_STORAGE_TYPE::DENSE_ERI;
+    else if( not ERISTORE.compare("PACKED") )
+      aoi.eriStore = ERI_STORAGE_TYPE::PACKED_ERI;
+    else if( not ERISTORE.compare("SPARSE") )
+      aoi.eriStore = ERI_STORAGE_TYPE::SPARSE_ERI;
+    else
+      CErr(ERISTORE + " not a valid INTS.ERISTORE",out);
+
+
+    // Parse the auxiliary basis for density fitting
+    if( aoi.cAlg == CONTRACTION_ALGORITHM::DENFIT ) {
+
+      std::string auxBasisName;
+      try {
+        auxBasisName = input.getData<std::string>("INTS.AUXBASIS");
+      } catch(...) {
+        CErr("INTS.AUXBASIS must be specified for INTS.ALG = DENFIT",out);
+      }
+
+      aoi.auxBasisSet = std::make_shared<BasisSet>(auxBasisName,
+        aoi.molecule(),aoi.basisSet().forceCart,false);
+
+    }
+
+    
+    // Parse the SEMIDIRECT I/O buffer size (MB)
+    if( aoi.cAlg == CONTRACTION_ALGORITHM::SEMIDIRECT ) {
+
+      size_t bufferMB = 8;
+      OPTOPT( bufferMB = input.getData<size_t>("INTS.SEMIDIRECTBUFFER"); )
+
+      if( bufferMB == 0 )
+        CErr("INTS.SEMIDIRECTBUFFER must be positive",out);
+
+      aoi.semiDirectBuffer = bufferMB * 1024 * 1024 / sizeof(double);
+
+    }
+
     
     // Parse Schwartz threshold
     OPTOPT( aoi.threshSchwartz = input.getData<double>("INTS.SCHWARTZ"); )
@@ -69,6 +69,10 @@ namespace ChronusQ {
 
     OPTOPT(blkSize = input.getData<size_t>("MISC.MEMBLK");)
 
+    // Back the memory partition by (2 MB) hugepages
+    bool hugePages = false;
+    OPTOPT(hugePages = input.getData<bool>("MISC.HUGEPAGES");)
+
     std::string postfixes = " KMGT";
     size_t indx = std::floor(std::log10(mem))/4;
     char postfix = postfixes.c_str()[indx];
@@ -86,11 +90,18 @@ namespace ChronusQ {
     out << "\n\n";
 
     out << "  *** Allocating " << memPrint << " " << postfix << "B *** \n";
+    if( hugePages ) 
+      out << "  *** Memory partition backed by 2 MB hugepages *** \n";
     out << "  *** ChronusQ will use " << GetNumThreads() 
         << " OpenMP threads ***\n\n";
     out << "\n\n";
 
-    return std::make_shared<CQMemManager>(mem,blkSize);
+    auto memManager = std::make_shared<CQMemManager>(mem,blkSize,hugePages);
+
+    // Print every allocation / deallocation
+    OPTOPT(memManager->setPrintAllocs(input.getData<bool>("MISC.MEMPRINT"));)
+
+    return memManager;
 
   }; // CQMiscOptions
 
@@ -54,6 +54,72 @@ namespace ChronusQ {
     OPTOPT(
       ss.scfControls.nIncFock = input.getData<size_t>("SCF.NINCFOCK");
     )
+    OPTOPT(
+      ss.scfControls.incFockScale = 
+        input.getData<double>("SCF.INCFOCKSCALE");
+    )
+    OPTOPT(
+      ss.scfControls.incFockResetTol = 
+        input.getData<double>("SCF.INCFOCKRESET");
+    )
+
+
+    // Density purification (in lieu of diagonalization)
+    OPTOPT(
+      std::string purifyString = input.getData<std::string>("SCF.PURIFY");
+
+      if( not purifyString.compare("TRS4") ) {
+        ss.scfControls.doPurify  = true;
+        ss.scfControls.purifyAlg = TRS4_PURIFICATION;
+      } else if( not purifyString.compare("CANONICAL") ) {
+        ss.scfControls.doPurify  = true;
+        ss.scfControls.purifyAlg = CANONICAL_PURIFICATION;
+      } else if( purifyString.compare("NONE") )
+        CErr(purifyString + " is not a valid SCF.PURIFY");
+    )
+    OPTOPT(
+      ss.scfControls.purifyTol = input.getData<double>("SCF.PURIFYTOL");
+    )
+    OPTOPT(
+      ss.scfControls.maxPurifyIter = 
+        input.getData<size_t>("SCF.PURIFYMAXITER");
+    )
+
+
+    // Fock diagonalization backend
+    OPTOPT(
+      std::string eigString = input.getData<std::string>("SCF.EIGALG");
+
+      if( not eigString.compare("QR") )
+        ss.scfControls.eigAlg = QR_EIGEN;
+      else if( not eigString.compare("DC") )
+        ss.scfControls.eigAlg = DC_EIGEN;
+      else if( not eigString.compare("MRRR") )
+        ss.scfControls.eigAlg = MRRR_EIGEN;
+      else
+        CErr(eigString + " is not a valid SCF.EIGALG");
+    )
+
+    // Number of virtual orbitals during the SCF iterations
+    OPTOPT(
+      ss.scfControls.nEigVirt = input.getData<int>("SCF.NEIGVIRT");
+    )
+
+
+    // Second-order (quasi-Newton) SCF
+    OPTOPT(
+      ss.scfControls.doSOSCF = input.getData<bool>("SCF.SOSCF");
+    )
+    OPTOPT(
+      ss.scfControls.soscfStartTol = input.getData<double>("SCF.SOSCFTOL");
+    )
+    OPTOPT(
+      ss.scfControls.soscfMaxStep = 
+        input.getData<double>("SCF.SOSCFMAXSTEP");
+    )
+    OPTOPT(
+      ss.scfControls.soscfNKeep = input.getData<size_t>("SCF.SOSCFNKEEP");
+    )
 
 
     // Guess
@@ -77,6 +143,28 @@ namespace ChronusQ {
 
 
 
+    // DIIS extrapolation scheme
+    OPTOPT(
+      std::string diisString = input.getData<std::string>("SCF.DIISALG");
+
+      if( not diisString.compare("CDIIS") )
+        ss.scfControls.diisAlg = CDIIS;
+      else if( not diisString.compare("EDIIS") )
+        ss.scfControls.diisAlg = EDIIS;
+      else if( not diisString.compare("ADIIS") )
+        ss.scfControls.diisAlg = ADIIS;
+      else if( not diisString.compare("CEDIIS") )
+        ss.scfControls.diisAlg = CEDIIS;
+      else if( not diisString.compare("CADIIS") )
+        ss.scfControls.diisAlg = CADIIS;
+      else
+        CErr(diisString + " is not a valid SCF.DIISALG");
+    )
+
+    // Switch from energy based DIIS to CDIIS
+    OPTOPT( ss.scfControls.diisSwitchTol = 
+              input.getData<double>("SCF.DIISSWITCH"); )
+
     // Handle DIIS options
     OPTOPT(
       bool doDIIS = input.getData<bool>("SCF.DIIS");
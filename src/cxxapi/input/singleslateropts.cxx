@@ -227,6 +227,37 @@ namespace ChronusQ {
         );
 
     }
+
+
+    // Atomic partition scheme for the KS numerical integration
+    PARTITION_SCHEME gridScheme = BECKE_PARTITION;
+    bool gridPrune = false, gridBox = false;
+    size_t basisCacheMem = 0;
+    double rhoThresh = 0.;
+    if( isKSRef ) {
+
+      std::string schemeStr = "BECKE";
+      OPTOPT(schemeStr = input.getData<std::string>("QM.GRIDWEIGHTS");)
+      trim(schemeStr);
+
+      if( not schemeStr.compare("SSF") )
+        gridScheme = SSF_PARTITION;
+      else if( schemeStr.compare("BECKE") )
+        CErr(schemeStr + " is not a valid QM.GRIDWEIGHTS",out);
+
+      // SG-1 style pruning of the angular grids
+      OPTOPT(gridPrune = input.getData<bool>("QM.GRIDPRUNE");)
+
+      // Spatially compact batching of the grid points
+      OPTOPT(gridBox = input.getData<bool>("QM.GRIDBOXES");)
+
+      // Memory (MB) to cache the basis on the grid between VXC builds
+      OPTOPT(basisCacheMem = input.getData<size_t>("QM.BASISCACHE") * 1e6;)
+
+      // Density below which the XC kernel is not evaluated
+      OPTOPT(rhoThresh = input.getData<double>("QM.DENSTHRESH");)
+
+    }
       
 
 
@@ -322,6 +353,23 @@ namespace ChronusQ {
             )
           );
 
+    if( isKSRef ) {
+      if( auto ks = std::dynamic_pointer_cast<KohnSham<double>>(ss) ) {
+        ks->intParam.scheme = gridScheme;
+        ks->intParam.prune  = gridPrune;
+        ks->intParam.boxBatch = gridBox;
+        ks->intParam.basisCacheMem = basisCacheMem;
+        ks->intParam.rhoThresh = rhoThresh;
+      }
+      if( auto ks = std::dynamic_pointer_cast<KohnSham<dcomplex>>(ss) ) {
+        ks->intParam.scheme = gridScheme;
+        ks->intParam.prune  = gridPrune;
+        ks->intParam.boxBatch = gridBox;
+        ks->intParam.basisCacheMem = basisCacheMem;
+        ks->intParam.rhoThresh = rhoThresh;
+      }
+    }
+
     return ss;
 
   }; // CQSingleSlaterOptions
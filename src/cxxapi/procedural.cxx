@@ -45,6 +45,40 @@
 
 namespace ChronusQ {
 
+  /**
+   *  Output the memory usage report (high-water mark, fragmentation and
+   *  per-tag peaks) of a CQMemManager and save it to the restart file.
+   *
+   *  \param [in]  out        Output device
+   *  \param [in]  memManager Memory manager of interest
+   *  \param [in]  rstFile    Restart file
+   */ 
+  void CQMemReport(std::ostream &out, CQMemManager &memManager,
+    SafeFile &rstFile) {
+
+    out << std::endl << BannerTop << std::endl << std::endl;
+    memManager.printReport(out);
+
+    double total = memManager.totalMemory();
+    double hwm   = memManager.highWaterMark();
+    double frag  = memManager.fragmentation();
+
+    rstFile.safeWriteData("/MEMORY/TOTAL",&total,{1});
+    rstFile.safeWriteData("/MEMORY/HIGHWATER",&hwm,{1});
+    rstFile.safeWriteData("/MEMORY/FRAGMENTATION",&frag,{1});
+
+    for( auto &tag : memManager.tagStats() ) {
+      if( not tag.nAlloc ) continue;
+
+      double peak   = tag.peak;
+      double nAlloc = tag.nAlloc;
+      rstFile.safeWriteData("/MEMORY/TAGS/" + tag.name + "/PEAK",&peak,{1});
+      rstFile.safeWriteData("/MEMORY/TAGS/" + tag.name + "/NALLOC",&nAlloc,
+        {1});
+    }
+
+  }; // CQMemReport
+
   void RunChronusQ(std::string inFileName,
     std::string outFileName, std::string rstFileName,
     std::string scrFileName) {
@@ -94,12 +128,19 @@ namespace ChronusQ {
 
 
     AOIntegrals aoints(*memManager,mol,basis);
-    auto ss = CQSingleSlaterOptions(std::cout,input,aoints);
+
+    std::shared_ptr<SingleSlaterBase> ss;
+    {
+      CQMemTag memTag(*memManager,"SCF");
+      ss = CQSingleSlaterOptions(std::cout,input,aoints);
+    }
 
 
     ss->savFile    = rstFile;
     aoints.savFile = rstFile;
 
+    if( not scrFileName.empty() ) aoints.scrFileName = scrFileName;
+
     // EM Perturbation for SCF
     EMPerturbation SCFpert;
 
@@ -109,21 +150,38 @@ namespace ChronusQ {
 
     if( not jobType.compare("SCF") or not jobType.compare("RT") ) {
 
-      aoints.computeCoreHam();
+      {
+        CQMemTag memTag(*memManager,"INTS");
+        aoints.computeCoreHam();
+      }
 
       // If INCORE, compute and store the ERIs
       if(aoints.cAlg == INCORE) aoints.computeERI();
 
+      // If DENFIT, compute and store the 3-index ERIs
+      if(aoints.cAlg == DENFIT) aoints.computeERI3Index();
+
+      // If SEMIDIRECT, compute and cache the ERIs on disk
+      if(aoints.cAlg == SEMIDIRECT) aoints.computeERISemiDirect();
+
+      CQMemTag memTag(*memManager,"SCF");
       ss->formGuess();
       ss->SCF(SCFpert);
     }
 
     if( not jobType.compare("RT") ) {
+      CQMemTag memTag(*memManager,"RT");
       auto rt = CQRealTimeOptions(std::cout,input,ss);
       rt->savFile = rstFile;
       rt->doPropagation();
     }
 
+    // Remove the SEMIDIRECT ERI cache
+    if( aoints.cAlg == SEMIDIRECT ) std::remove(aoints.scrFileName.c_str());
+
+    // Report the memory usage
+    CQMemReport(std::cout,*memManager,rstFile);
+
     // Output CQ footer
     CQOutputFooter(std::cout);
 
@@ -37,6 +37,8 @@
 
 #include <cqlinalg/blasext.hpp>
 
+#include <cstdio>
+
 
 using namespace ChronusQ;
 
@@ -187,6 +189,49 @@ void HerMatLoc(char UPLO, size_t N, T *A) {
   memManager->free(SX,SX2,Rand);
 
 
+// Read the reference data off disk and perform / compare the contraction
+// using the contraction algorithm CALG and the ERI storage ERISTORE
+#define STORAGE_CONTRACT_TEST(FIELD,HER,TYPE,STORAGE,CALG,ERISTORE) \
+  SafeFile refFile(FUNC_REFERENCE "contract.hdf5",true);\
+  \
+  CONTRACT_BUILD(FIELD,HER,TYPE) \
+  \
+  aoints.cAlg     = CALG; \
+  aoints.eriStore = ERISTORE; \
+  \
+  /* Keep the screening error of the sparse storage below the tolerance */ \
+  aoints.threshSchwartz = 1e-14; \
+  \
+  /* Small enough to force several (asynchronously prefetched) batches */ \
+  aoints.semiDirectBuffer = 65536; \
+  aoints.scrFileName      = "functest_contract.scr"; \
+  \
+  if( CALG == INCORE ) aoints.computeERI(); \
+  \
+  refFile.readData(STORAGE "/X",Rand);\
+  refFile.readData(STORAGE "/AX",SX2);\
+  \
+  aoints.twoBodyContract(cont);\
+  \
+  double maxDiff(0.);\
+  for(auto i = 0; i < NB*NB; i++) \
+    maxDiff = std::max(maxDiff,std::abs(SX[i] - SX2[i]));\
+  \
+  BOOST_CHECK(maxDiff < 1e-10);\
+  if( CALG == SEMIDIRECT ) std::remove(aoints.scrFileName.c_str());\
+  memManager->free(SX,SX2,Rand);
+
+
+#define PACKED_CONTRACT_TEST(FIELD,HER,TYPE,STORAGE) \
+  STORAGE_CONTRACT_TEST(FIELD,HER,TYPE,STORAGE,INCORE,PACKED_ERI)
+
+#define SPARSE_CONTRACT_TEST(FIELD,HER,TYPE,STORAGE) \
+  STORAGE_CONTRACT_TEST(FIELD,HER,TYPE,STORAGE,INCORE,SPARSE_ERI)
+
+#define SEMIDIRECT_CONTRACT_TEST(FIELD,HER,TYPE,STORAGE) \
+  STORAGE_CONTRACT_TEST(FIELD,HER,TYPE,STORAGE,SEMIDIRECT,DENSE_ERI)
+
+
 
 #endif
 
@@ -339,3 +384,476 @@ BOOST_AUTO_TEST_SUITE_END()
 
 // End direct contraction suite
 BOOST_AUTO_TEST_SUITE_END()
+
+
+
+// INCORE PACKED_ERI contract test suite (compared to the INCORE references)
+#ifndef _CQ_GENERATE_TESTS
+BOOST_AUTO_TEST_SUITE( INCORE_PACKED_CONTRACTION )
+
+
+// Real contraction test suite
+BOOST_AUTO_TEST_SUITE( REAL_INCORE_PACKED_CONTRACTION )
+
+// Real Hermetian "J" contraction test
+BOOST_FIXTURE_TEST_CASE( HER_J_CONTRACT, SerialJob ) {
+
+  PACKED_CONTRACT_TEST(double,HERMETIAN,COULOMB,"CONTRACTION/HER/REAL/J");
+
+}
+
+// Real Non-Hermetian "J" contraction test
+BOOST_FIXTURE_TEST_CASE( NONHER_J_CONTRACT, SerialJob ) {
+
+  PACKED_CONTRACT_TEST(double,NONHERMETIAN,COULOMB,
+    "CONTRACTION/NONHER/REAL/J");
+
+}
+
+// Real Hermetian "K" contraction test
+BOOST_FIXTURE_TEST_CASE( HER_K_CONTRACT, SerialJob ) {
+
+  PACKED_CONTRACT_TEST(double,HERMETIAN,EXCHANGE,"CONTRACTION/HER/REAL/K");
+
+}
+
+// Real Non-Hermetian "K" contraction test
+BOOST_FIXTURE_TEST_CASE( NONHER_K_CONTRACT, SerialJob ) {
+
+  PACKED_CONTRACT_TEST(double,NONHERMETIAN,COULOMB,
+    "CONTRACTION/NONHER/REAL/K");
+
+}
+
+// Parallel Real INCORE PACKED_ERI contraction tests
+#ifdef _CQ_DO_PARTESTS
+
+// Parallel Real Hermetian "J" contraction test
+BOOST_FIXTURE_TEST_CASE( PAR_HER_J_CONTRACT, ParallelJob ) {
+
+  PACKED_CONTRACT_TEST(double,HERMETIAN,COULOMB,"CONTRACTION/HER/REAL/J");
+
+}
+
+// Parallel Real Non-Hermetian "J" contraction test
+BOOST_FIXTURE_TEST_CASE( PAR_NONHER_J_CONTRACT, ParallelJob ) {
+
+  PACKED_CONTRACT_TEST(double,NONHERMETIAN,COULOMB,
+    "CONTRACTION/NONHER/REAL/J");
+
+}
+
+// Parallel Real Hermetian "K" contraction test
+BOOST_FIXTURE_TEST_CASE( PAR_HER_K_CONTRACT, ParallelJob ) {
+
+  PACKED_CONTRACT_TEST(double,HERMETIAN,EXCHANGE,"CONTRACTION/HER/REAL/K");
+
+}
+
+// Parallel Real Non-Hermetian "K" contraction test
+BOOST_FIXTURE_TEST_CASE( PAR_NONHER_K_CONTRACT, ParallelJob ) {
+
+  PACKED_CONTRACT_TEST(double,NONHERMETIAN,COULOMB,
+    "CONTRACTION/NONHER/REAL/K");
+
+}
+
+#endif
+
+// End real contraction test suite
+BOOST_AUTO_TEST_SUITE_END()
+
+
+// Complex contraction test suite
+BOOST_AUTO_TEST_SUITE( COMPLEX_INCORE_PACKED_CONTRACTION )
+
+// Complex Hermetian "J" contraction test
+BOOST_FIXTURE_TEST_CASE( HER_J_CONTRACT, SerialJob ) {
+
+  PACKED_CONTRACT_TEST(dcomplex,HERMETIAN,COULOMB,"CONTRACTION/HER/COMPLEX/J");
+
+}
+
+// Complex Non-Hermetian "J" contraction test
+BOOST_FIXTURE_TEST_CASE( NONHER_J_CONTRACT, SerialJob ) {
+
+  PACKED_CONTRACT_TEST(dcomplex,NONHERMETIAN,COULOMB,
+    "CONTRACTION/NONHER/COMPLEX/J");
+
+}
+
+// Complex Hermetian "K" contraction test
+BOOST_FIXTURE_TEST_CASE( HER_K_CONTRACT, SerialJob ) {
+
+  PACKED_CONTRACT_TEST(dcomplex,HERMETIAN,EXCHANGE,
+    "CONTRACTION/HER/COMPLEX/K");
+
+}
+
+// Complex Non-Hermetian "K" contraction test
+BOOST_FIXTURE_TEST_CASE( NONHER_K_CONTRACT, SerialJob ) {
+
+  PACKED_CONTRACT_TEST(dcomplex,HERMETIAN,EXCHANGE,
+    "CONTRACTION/NONHER/COMPLEX/K");
+
+}
+
+// Parallel Complex INCORE PACKED_ERI contraction tests
+#ifdef _CQ_DO_PARTESTS
+
+// Parallel Complex Hermetian "J" contraction test
+BOOST_FIXTURE_TEST_CASE( PAR_HER_J_CONTRACT, ParallelJob ) {
+
+  PACKED_CONTRACT_TEST(dcomplex,HERMETIAN,COULOMB,"CONTRACTION/HER/COMPLEX/J");
+
+}
+
+// Parallel Complex Non-Hermetian "J" contraction test
+BOOST_FIXTURE_TEST_CASE( PAR_NONHER_J_CONTRACT, ParallelJob ) {
+
+  PACKED_CONTRACT_TEST(dcomplex,NONHERMETIAN,COULOMB,
+    "CONTRACTION/NONHER/COMPLEX/J");
+
+}
+
+// Parallel Complex Hermetian "K" contraction test
+BOOST_FIXTURE_TEST_CASE( PAR_HER_K_CONTRACT, ParallelJob ) {
+
+  PACKED_CONTRACT_TEST(dcomplex,HERMETIAN,EXCHANGE,
+    "CONTRACTION/HER/COMPLEX/K");
+
+}
+
+// Parallel Complex Non-Hermetian "K" contraction test
+BOOST_FIXTURE_TEST_CASE( PAR_NONHER_K_CONTRACT, ParallelJob ) {
+
+  PACKED_CONTRACT_TEST(dcomplex,HERMETIAN,EXCHANGE,
+    "CONTRACTION/NONHER/COMPLEX/K");
+
+}
+
+#endif
+
+// End complex contraction test suite
+BOOST_AUTO_TEST_SUITE_END()
+
+
+// End INCORE PACKED_ERI contraction suite
+BOOST_AUTO_TEST_SUITE_END()
+#endif
+
+
+
+// INCORE SPARSE_ERI contract test suite (compared to the INCORE references)
+#ifndef _CQ_GENERATE_TESTS
+BOOST_AUTO_TEST_SUITE( INCORE_SPARSE_CONTRACTION )
+
+
+// Real contraction test suite
+BOOST_AUTO_TEST_SUITE( REAL_INCORE_SPARSE_CONTRACTION )
+
+// Real Hermetian "J" contraction test
+BOOST_FIXTURE_TEST_CASE( HER_J_CONTRACT, SerialJob ) {
+
+  SPARSE_CONTRACT_TEST(double,HERMETIAN,COULOMB,"CONTRACTION/HER/REAL/J");
+
+}
+
+// Real Non-Hermetian "J" contraction test
+BOOST_FIXTURE_TEST_CASE( NONHER_J_CONTRACT, SerialJob ) {
+
+  SPARSE_CONTRACT_TEST(double,NONHERMETIAN,COULOMB,
+    "CONTRACTION/NONHER/REAL/J");
+
+}
+
+// Real Hermetian "K" contraction test
+BOOST_FIXTURE_TEST_CASE( HER_K_CONTRACT, SerialJob ) {
+
+  SPARSE_CONTRACT_TEST(double,HERMETIAN,EXCHANGE,"CONTRACTION/HER/REAL/K");
+
+}
+
+// Real Non-Hermetian "K" contraction test
+BOOST_FIXTURE_TEST_CASE( NONHER_K_CONTRACT, SerialJob ) {
+
+  SPARSE_CONTRACT_TEST(double,NONHERMETIAN,COULOMB,
+    "CONTRACTION/NONHER/REAL/K");
+
+}
+
+// Parallel Real INCORE SPARSE_ERI contraction tests
+#ifdef _CQ_DO_PARTESTS
+
+// Parallel Real Hermetian "J" contraction test
+BOOST_FIXTURE_TEST_CASE( PAR_HER_J_CONTRACT, ParallelJob ) {
+
+  SPARSE_CONTRACT_TEST(double,HERMETIAN,COULOMB,"CONTRACTION/HER/REAL/J");
+
+}
+
+// Parallel Real Non-Hermetian "J" contraction test
+BOOST_FIXTURE_TEST_CASE( PAR_NONHER_J_CONTRACT, ParallelJob ) {
+
+  SPARSE_CONTRACT_TEST(double,NONHERMETIAN,COULOMB,
+    "CONTRACTION/NONHER/REAL/J");
+
+}
+
+// Parallel Real Hermetian "K" contraction test
+BOOST_FIXTURE_TEST_CASE( PAR_HER_K_CONTRACT, ParallelJob ) {
+
+  SPARSE_CONTRACT_TEST(double,HERMETIAN,EXCHANGE,"CONTRACTION/HER/REAL/K");
+
+}
+
+// Parallel Real Non-Hermetian "K" contraction test
+BOOST_FIXTURE_TEST_CASE( PAR_NONHER_K_CONTRACT, ParallelJob ) {
+
+  SPARSE_CONTRACT_TEST(double,NONHERMETIAN,COULOMB,
+    "CONTRACTION/NONHER/REAL/K");
+
+}
+
+#endif
+
+// End real contraction test suite
+BOOST_AUTO_TEST_SUITE_END()
+
+
+// Complex contraction test suite
+BOOST_AUTO_TEST_SUITE( COMPLEX_INCORE_SPARSE_CONTRACTION )
+
+// Complex Hermetian "J" contraction test
+BOOST_FIXTURE_TEST_CASE( HER_J_CONTRACT, SerialJob ) {
+
+  SPARSE_CONTRACT_TEST(dcomplex,HERMETIAN,COULOMB,"CONTRACTION/HER/COMPLEX/J");
+
+}
+
+// Complex Non-Hermetian "J" contraction test
+BOOST_FIXTURE_TEST_CASE( NONHER_J_CONTRACT, SerialJob ) {
+
+  SPARSE_CONTRACT_TEST(dcomplex,NONHERMETIAN,COULOMB,
+    "CONTRACTION/NONHER/COMPLEX/J");
+
+}
+
+// Complex Hermetian "K" contraction test
+BOOST_FIXTURE_TEST_CASE( HER_K_CONTRACT, SerialJob ) {
+
+  SPARSE_CONTRACT_TEST(dcomplex,HERMETIAN,EXCHANGE,
+    "CONTRACTION/HER/COMPLEX/K");
+
+}
+
+// Complex Non-Hermetian "K" contraction test
+BOOST_FIXTURE_TEST_CASE( NONHER_K_CONTRACT, SerialJob ) {
+
+  SPARSE_CONTRACT_TEST(dcomplex,HERMETIAN,EXCHANGE,
+    "CONTRACTION/NONHER/COMPLEX/K");
+
+}
+
+// Parallel Complex INCORE SPARSE_ERI contraction tests
+#ifdef _CQ_DO_PARTESTS
+
+// Parallel Complex Hermetian "J" contraction test
+BOOST_FIXTURE_TEST_CASE( PAR_HER_J_CONTRACT, ParallelJob ) {
+
+  SPARSE_CONTRACT_TEST(dcomplex,HERMETIAN,COULOMB,"CONTRACTION/HER/COMPLEX/J");
+
+}
+
+// Parallel Complex Non-Hermetian "J" contraction test
+BOOST_FIXTURE_TEST_CASE( PAR_NONHER_J_CONTRACT, ParallelJob ) {
+
+  SPARSE_CONTRACT_TEST(dcomplex,NONHERMETIAN,COULOMB,
+    "CONTRACTION/NONHER/COMPLEX/J");
+
+}
+
+// Parallel Complex Hermetian "K" contraction test
+BOOST_FIXTURE_TEST_CASE( PAR_HER_K_CONTRACT, ParallelJob ) {
+
+  SPARSE_CONTRACT_TEST(dcomplex,HERMETIAN,EXCHANGE,
+    "CONTRACTION/HER/COMPLEX/K");
+
+}
+
+// Parallel Complex Non-Hermetian "K" contraction test
+BOOST_FIXTURE_TEST_CASE( PAR_NONHER_K_CONTRACT, ParallelJob ) {
+
+  SPARSE_CONTRACT_TEST(dcomplex,HERMETIAN,EXCHANGE,
+    "CONTRACTION/NONHER/COMPLEX/K");
+
+}
+
+#endif
+
+// End complex contraction test suite
+BOOST_AUTO_TEST_SUITE_END()
+
+
+// End INCORE SPARSE_ERI contraction suite
+BOOST_AUTO_TEST_SUITE_END()
+#endif
+
+
+
+// SEMIDIRECT contract test suite (compared to the INCORE references)
+#ifndef _CQ_GENERATE_TESTS
+BOOST_AUTO_TEST_SUITE( SEMIDIRECT_CONTRACTION )
+
+
+// Real contraction test suite
+BOOST_AUTO_TEST_SUITE( REAL_SEMIDIRECT_CONTRACTION )
+
+// Real Hermetian "J" contraction test
+BOOST_FIXTURE_TEST_CASE( HER_J_CONTRACT, SerialJob ) {
+
+  SEMIDIRECT_CONTRACT_TEST(double,HERMETIAN,COULOMB,"CONTRACTION/HER/REAL/J");
+
+}
+
+// Real Non-Hermetian "J" contraction test
+BOOST_FIXTURE_TEST_CASE( NONHER_J_CONTRACT, SerialJob ) {
+
+  SEMIDIRECT_CONTRACT_TEST(double,NONHERMETIAN,COULOMB,
+    "CONTRACTION/NONHER/REAL/J");
+
+}
+
+// Real Hermetian "K" contraction test
+BOOST_FIXTURE_TEST_CASE( HER_K_CONTRACT, SerialJob ) {
+
+  SEMIDIRECT_CONTRACT_TEST(double,HERMETIAN,EXCHANGE,"CONTRACTION/HER/REAL/K");
+
+}
+
+// Real Non-Hermetian "K" contraction test
+BOOST_FIXTURE_TEST_CASE( NONHER_K_CONTRACT, SerialJob ) {
+
+  SEMIDIRECT_CONTRACT_TEST(double,NONHERMETIAN,COULOMB,
+    "CONTRACTION/NONHER/REAL/K");
+
+}
+
+// Parallel Real SEMIDIRECT contraction tests
+#ifdef _CQ_DO_PARTESTS
+
+// Parallel Real Hermetian "J" contraction test
+BOOST_FIXTURE_TEST_CASE( PAR_HER_J_CONTRACT, ParallelJob ) {
+
+  SEMIDIRECT_CONTRACT_TEST(double,HERMETIAN,COULOMB,"CONTRACTION/HER/REAL/J");
+
+}
+
+// Parallel Real Non-Hermetian "J" contraction test
+BOOST_FIXTURE_TEST_CASE( PAR_NONHER_J_CONTRACT, ParallelJob ) {
+
+  SEMIDIRECT_CONTRACT_TEST(double,NONHERMETIAN,COULOMB,
+    "CONTRACTION/NONHER/REAL/J");
+
+}
+
+// Parallel Real Hermetian "K" contraction test
+BOOST_FIXTURE_TEST_CASE( PAR_HER_K_CONTRACT, ParallelJob ) {
+
+  SEMIDIRECT_CONTRACT_TEST(double,HERMETIAN,EXCHANGE,"CONTRACTION/HER/REAL/K");
+
+}
+
+// Parallel Real Non-Hermetian "K" contraction test
+BOOST_FIXTURE_TEST_CASE( PAR_NONHER_K_CONTRACT, ParallelJob ) {
+
+  SEMIDIRECT_CONTRACT_TEST(double,NONHERMETIAN,COULOMB,
+    "CONTRACTION/NONHER/REAL/K");
+
+}
+
+#endif
+
+// End real contraction test suite
+BOOST_AUTO_TEST_SUITE_END()
+
+
+// Complex contraction test suite
+BOOST_AUTO_TEST_SUITE( COMPLEX_SEMIDIRECT_CONTRACTION )
+
+// Complex Hermetian "J" contraction test
+BOOST_FIXTURE_TEST_CASE( HER_J_CONTRACT, SerialJob ) {
+
+  SEMIDIRECT_CONTRACT_TEST(dcomplex,HERMETIAN,COULOMB,
+    "CONTRACTION/HER/COMPLEX/J");
+
+}
+
+// Complex Non-Hermetian "J" contraction test
+BOOST_FIXTURE_TEST_CASE( NONHER_J_CONTRACT, SerialJob ) {
+
+  SEMIDIRECT_CONTRACT_TEST(dcomplex,NONHERMETIAN,COULOMB,
+    "CONTRACTION/NONHER/COMPLEX/J");
+
+}
+
+// Complex Hermetian "K" contraction test
+BOOST_FIXTURE_TEST_CASE( HER_K_CONTRACT, SerialJob ) {
+
+  SEMIDIRECT_CONTRACT_TEST(dcomplex,HERMETIAN,EXCHANGE,
+    "CONTRACTION/HER/COMPLEX/K");
+
+}
+
+// Complex Non-Hermetian "K" contraction test
+BOOST_FIXTURE_TEST_CASE( NONHER_K_CONTRACT, SerialJob ) {
+
+  SEMIDIRECT_CONTRACT_TEST(dcomplex,HERMETIAN,EXCHANGE,
+    "CONTRACTION/NONHER/COMPLEX/K");
+
+}
+
+// Parallel Complex SEMIDIRECT contraction tests
+#ifdef _CQ_DO_PARTESTS
+
+// Parallel Complex Hermetian "J" contraction test
+BOOST_FIXTURE_TEST_CASE( PAR_HER_J_CONTRACT, ParallelJob ) {
+
+  SEMIDIRECT_CONTRACT_TEST(dcomplex,HERMETIAN,COULOMB,
+    "CONTRACTION/HER/COMPLEX/J");
+
+}
+
+// Parallel Complex Non-Hermetian "J" contraction test
+BOOST_FIXTURE_TEST_CASE( PAR_NONHER_J_CONTRACT, ParallelJob ) {
+
+  SEMIDIRECT_CONTRACT_TEST(dcomplex,NONHERMETIAN,COULOMB,
+    "CONTRACTION/NONHER/COMPLEX/J");
+
+}
+
+// Parallel Complex Hermetian "K" contraction test
+BOOST_FIXTURE_TEST_CASE( PAR_HER_K_CONTRACT, ParallelJob ) {
+
+  SEMIDIRECT_CONTRACT_TEST(dcomplex,HERMETIAN,EXCHANGE,
+    "CONTRACTION/HER/COMPLEX/K");
+
+}
+
+// Parallel Complex Non-Hermetian "K" contraction test
+BOOST_FIXTURE_TEST_CASE( PAR_NONHER_K_CONTRACT, ParallelJob ) {
+
+  SEMIDIRECT_CONTRACT_TEST(dcomplex,HERMETIAN,EXCHANGE,
+    "CONTRACTION/NONHER/COMPLEX/K");
+
+}
+
+#endif
+
+// End complex contraction test suite
+BOOST_AUTO_TEST_SUITE_END()
+
+
+// End SEMIDIRECT contraction suite
+BOOST_AUTO_TEST_SUITE_END()
+#endif
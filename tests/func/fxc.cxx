@@ -0,0 +1,225 @@
+/*
+ *  This file is part of the Chronus Quantum (ChronusQ) software package
+ *
+ *  Copyright (C) 2014-2017 Li Research Group (University of Washington)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ *  Contact the Developers:
+ *    E-Mail: xsli@uw.edu
+ *
+ */
+#include <func.hpp>
+
+#include <cxxapi/input.hpp>
+#include <cxxapi/options.hpp>
+#include <cxxapi/boilerplate.hpp>
+
+#include <util/threads.hpp>
+
+#include <memmanager.hpp>
+#include <cerr.hpp>
+#include <molecule.hpp>
+#include <basisset.hpp>
+#include <aointegrals.hpp>
+#include <singleslater.hpp>
+
+#include <cqlinalg/blas1.hpp>
+#include <cqlinalg/blas3.hpp>
+
+
+using namespace ChronusQ;
+
+
+// Step of the central finite difference of VXC
+#define FXC_FD_STEP 1e-4
+
+// Number of (random) occupied orbitals per spin
+#define FXC_FD_NOCC 5
+
+
+/**
+ *  \brief Compare the XC kernel contraction (contractFXC) with the
+ *  central finite difference of VXC
+ *
+ *    fxc[X] ~ (VXC[D + hX] - VXC[D - hX]) / 2h
+ *
+ *  for the Kohn--Sham reference specified in INPUT. The density of each
+ *  spin is built from random orbitals, D(s) = C(s) C(s)**T, and the trial
+ *  density is the first order change of D(s) wrt C(s) -> C(s) + hB(s),
+ *
+ *    X(s) = C(s) B(s)**T + B(s) C(s)**T
+ *
+ *  such that the displaced densities are exactly (C(s) +- hB(s))
+ *  (C(s) +- hB(s))**T (positive semidefinite) and the central difference
+ *  of the densities is exactly X.
+ */
+#define FXC_FD_TEST(INPUT) \
+  CQInputFile input(FUNC_INPUT INPUT);\
+  \
+  auto memManager = CQMiscOptions(std::cout,input); \
+  \
+  Molecule mol(std::move(CQMoleculeOptions(std::cout,input))); \
+  BasisSet basis(std::move(CQBasisSetOptions(std::cout,input,mol))); \
+  AOIntegrals aoints(*memManager,mol,basis); \
+  \
+  auto ss = CQSingleSlaterOptions(std::cout,input,aoints); \
+  auto ks = std::dynamic_pointer_cast<KohnSham<double>>(ss); \
+  BOOST_REQUIRE( ks != nullptr ); \
+  \
+  size_t NB   = basis.nBasis; \
+  size_t NOcc = FXC_FD_NOCC; \
+  size_t NMat = ks->onePDM.size(); \
+  \
+  std::default_random_engine e(1991);\
+  std::uniform_real_distribution<> dis(-0.5,0.5); \
+  \
+  /* Random orbitals (C) and their displacements (B) for each spin */ \
+  std::vector<double*> C, B; \
+  for(auto s = 0; s < NMat; s++) { \
+    C.emplace_back(memManager->malloc<double>(NB*NOcc)); \
+    B.emplace_back(memManager->malloc<double>(NB*NOcc)); \
+    for(auto i = 0; i < NB*NOcc; i++) { \
+      C.back()[i] = dis(e); \
+      B.back()[i] = dis(e); \
+    } \
+  } \
+  \
+  double *CP   = memManager->malloc<double>(NB*NOcc); \
+  double *DSpn = memManager->malloc<double>(2*NB*NB); \
+  \
+  /* Alpha (beta) density of the orbitals C + hB for the first (last) */ \
+  /* spin, and (SCALAR, MZ) = (DA + DB, DA - DB) */ \
+  auto formDen = [&](double h, std::vector<double*> &DEN) { \
+    for(auto s = 0; s < 2; s++) { \
+      size_t iS = std::min(size_t(s),NMat-1); \
+      std::copy_n(C[iS],NB*NOcc,CP); \
+      DaxPy(NB*NOcc,h,B[iS],1,CP,1); \
+      Gemm('N','T',NB,NB,NOcc,1.,CP,NB,CP,NB,0.,DSpn + s*NB*NB,NB); \
+    } \
+    for(auto i = 0; i < NB*NB; i++) { \
+      DEN[SCALAR][i] = DSpn[i] + DSpn[i + NB*NB]; \
+      if( NMat > 1 ) DEN[MZ][i] = DSpn[i] - DSpn[i + NB*NB]; \
+    } \
+  }; \
+  \
+  /* Trial densities */ \
+  std::vector<double*> X, AX, VP, VM; \
+  for(auto s = 0; s < NMat; s++) { \
+    X.emplace_back(memManager->malloc<double>(NB*NB)); \
+    AX.emplace_back(memManager->malloc<double>(NB*NB)); \
+    VP.emplace_back(memManager->malloc<double>(NB*NB)); \
+    VM.emplace_back(memManager->malloc<double>(NB*NB)); \
+  } \
+  \
+  for(auto s = 0; s < 2; s++) { \
+    size_t iS = std::min(size_t(s),NMat-1); \
+    Gemm('N','T',NB,NB,NOcc,1.,C[iS],NB,B[iS],NB,0.,DSpn + s*NB*NB,NB); \
+    for(auto j = 0; j < NB; j++) \
+    for(auto i = 0; i <= j; i++) { \
+      double x = DSpn[i + j*NB + s*NB*NB] + DSpn[j + i*NB + s*NB*NB]; \
+      DSpn[i + j*NB + s*NB*NB] = x; \
+      DSpn[j + i*NB + s*NB*NB] = x; \
+    } \
+  } \
+  for(auto i = 0; i < NB*NB; i++) { \
+    X[SCALAR][i] = DSpn[i] + DSpn[i + NB*NB]; \
+    if( NMat > 1 ) X[MZ][i] = DSpn[i] - DSpn[i + NB*NB]; \
+  } \
+  \
+  /* Central finite difference of VXC */ \
+  formDen(FXC_FD_STEP,ks->onePDM); \
+  ks->formVXC(); \
+  for(auto s = 0; s < NMat; s++) std::copy_n(ks->VXC[s],NB*NB,VP[s]); \
+  \
+  formDen(-FXC_FD_STEP,ks->onePDM); \
+  ks->formVXC(); \
+  for(auto s = 0; s < NMat; s++) std::copy_n(ks->VXC[s],NB*NB,VM[s]); \
+  \
+  /* XC kernel contraction at the undisplaced density */ \
+  formDen(0.,ks->onePDM); \
+  std::vector<XCKernelContraction> cont = { { X, AX } }; \
+  ks->contractFXC(cont); \
+  \
+  double maxDiff(0.), maxFD(0.); \
+  for(auto s = 0; s < NMat; s++) \
+  for(auto i = 0; i < NB*NB; i++) { \
+    double fd = (VP[s][i] - VM[s][i]) / (2. * FXC_FD_STEP); \
+    maxFD   = std::max(maxFD,std::abs(fd)); \
+    maxDiff = std::max(maxDiff,std::abs(fd - AX[s][i])); \
+  } \
+  \
+  BOOST_CHECK( maxFD > 1e-6 ); \
+  BOOST_CHECK_MESSAGE( maxDiff < 1e-6 * std::max(1.,maxFD), \
+    "FXC TEST FAILED " << maxDiff << " (MAX FD " << maxFD << ")" ); \
+  \
+  for(auto s = 0; s < NMat; s++) \
+    memManager->free(C[s],B[s],X[s],AX[s],VP[s],VM[s]); \
+  memManager->free(CP,DSpn);
+
+
+
+
+// XC kernel contraction test suite
+BOOST_AUTO_TEST_SUITE( FXC_CONTRACTION )
+
+// RKS LDA kernel
+BOOST_FIXTURE_TEST_CASE( RKS_LDA_FXC, SerialJob ) {
+
+  FXC_FD_TEST("fxc_rlsda.inp");
+
+}
+
+// UKS LDA kernel
+BOOST_FIXTURE_TEST_CASE( UKS_LDA_FXC, SerialJob ) {
+
+  FXC_FD_TEST("fxc_ulsda.inp");
+
+}
+
+// RKS GGA kernel
+BOOST_FIXTURE_TEST_CASE( RKS_GGA_FXC, SerialJob ) {
+
+  FXC_FD_TEST("fxc_rblyp.inp");
+
+}
+
+// UKS GGA kernel
+BOOST_FIXTURE_TEST_CASE( UKS_GGA_FXC, SerialJob ) {
+
+  FXC_FD_TEST("fxc_ublyp.inp");
+
+}
+
+#ifdef _CQ_DO_PARTESTS
+
+// SMP RKS GGA kernel
+BOOST_FIXTURE_TEST_CASE( PAR_RKS_GGA_FXC, ParallelJob ) {
+
+  FXC_FD_TEST("fxc_rblyp.inp");
+
+}
+
+// SMP UKS GGA kernel
+BOOST_FIXTURE_TEST_CASE( PAR_UKS_GGA_FXC, ParallelJob ) {
+
+  FXC_FD_TEST("fxc_ublyp.inp");
+
+}
+
+#endif
+
+// End FXC_CONTRACTION suite
+BOOST_AUTO_TEST_SUITE_END()
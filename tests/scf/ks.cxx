@@ -98,6 +98,106 @@ BOOST_FIXTURE_TEST_CASE( KS_CART_B3LYP, SerialJob ) {
 
 }
 
+// Spatially compact grid batches
+BOOST_FIXTURE_TEST_CASE( KS_BOXES_B3LYP, SerialJob ) {
+
+  CQSCFALTTEST( scf/serial/rks/water_cc-pVTZ_B3LYP_boxes, 
+    water_cc-pVTZ_B3LYP.bin.ref );
+
+}
+
+// Spatially compact grid batches (UKS)
+BOOST_FIXTURE_TEST_CASE( KS_BOXES_UB3LYP, SerialJob ) {
+
+  CQSCFALTTEST( scf/serial/uks/oxygen_6-311pG**_B3LYP_boxes, 
+    oxygen_6-311pG**_B3LYP.bin.ref );
+
+}
+
+// Partially cached basis on the grid
+BOOST_FIXTURE_TEST_CASE( KS_BASISCACHE_BLYP, SerialJob ) {
+
+  CQSCFALTTEST( scf/serial/rks/water_cc-pVTZ_BLYP_basiscache, 
+    water_cc-pVTZ_BLYP.bin.ref );
+
+}
+
+// Fully cached basis on the grid (UKS)
+BOOST_FIXTURE_TEST_CASE( KS_BASISCACHE_UB3LYP, SerialJob ) {
+
+  CQSCFALTTEST( scf/serial/uks/oxygen_6-311pG**_B3LYP_basiscache, 
+    oxygen_6-311pG**_B3LYP.bin.ref );
+
+}
+
+// Stratmann-Scuseria-Frisch partition weights
+BOOST_FIXTURE_TEST_CASE( KS_SSF_B3LYP, SerialJob ) {
+
+  CQSCFENERGYTEST( scf/serial/rks/water_cc-pVTZ_B3LYP_ssf, 
+    water_cc-pVTZ_B3LYP.bin.ref, 5e-5 );
+
+}
+
+// Stratmann-Scuseria-Frisch partition weights (UKS)
+BOOST_FIXTURE_TEST_CASE( KS_SSF_UB3LYP, SerialJob ) {
+
+  CQSCFENERGYTEST( scf/serial/uks/oxygen_6-311pG**_B3LYP_ssf, 
+    oxygen_6-311pG**_B3LYP.bin.ref, 5e-5 );
+
+}
+
+// SG-1 pruned angular grids
+BOOST_FIXTURE_TEST_CASE( KS_PRUNE_B3LYP, SerialJob ) {
+
+  CQSCFENERGYTEST( scf/serial/rks/water_cc-pVTZ_B3LYP_prune, 
+    water_cc-pVTZ_B3LYP.bin.ref, 5e-4 );
+
+}
+
+// SG-1 pruned angular grids (UKS)
+BOOST_FIXTURE_TEST_CASE( KS_PRUNE_UB3LYP, SerialJob ) {
+
+  CQSCFENERGYTEST( scf/serial/uks/oxygen_6-311pG**_B3LYP_prune, 
+    oxygen_6-311pG**_B3LYP.bin.ref, 5e-4 );
+
+}
+
+#ifdef _CQ_DO_PARTESTS
+
+// SMP Spatially compact grid batches
+BOOST_FIXTURE_TEST_CASE( PAR_KS_BOXES_B3LYP, ParallelJob ) {
+
+  CQSCFALTTEST( scf/parallel/rks/water_cc-pVTZ_B3LYP_boxes, 
+    water_cc-pVTZ_B3LYP.bin.ref );
+
+}
+
+// SMP Partially cached basis on the grid
+BOOST_FIXTURE_TEST_CASE( PAR_KS_BASISCACHE_BLYP, ParallelJob ) {
+
+  CQSCFALTTEST( scf/parallel/rks/water_cc-pVTZ_BLYP_basiscache, 
+    water_cc-pVTZ_BLYP.bin.ref );
+
+}
+
+// SMP Stratmann-Scuseria-Frisch partition weights
+BOOST_FIXTURE_TEST_CASE( PAR_KS_SSF_B3LYP, ParallelJob ) {
+
+  CQSCFENERGYTEST( scf/parallel/rks/water_cc-pVTZ_B3LYP_ssf, 
+    water_cc-pVTZ_B3LYP.bin.ref, 5e-5 );
+
+}
+
+// SMP SG-1 pruned angular grids
+BOOST_FIXTURE_TEST_CASE( PAR_KS_PRUNE_B3LYP, ParallelJob ) {
+
+  CQSCFENERGYTEST( scf/parallel/rks/water_cc-pVTZ_B3LYP_prune, 
+    water_cc-pVTZ_B3LYP.bin.ref, 5e-4 );
+
+}
+
+#endif
+
 // End KS_FUNC suite
 BOOST_AUTO_TEST_SUITE_END()
 
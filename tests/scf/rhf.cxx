@@ -33,6 +33,101 @@ BOOST_FIXTURE_TEST_CASE( Water_631Gd, SerialJob ) {
  
 };
 
+// Water 6-31G(d) adaptive incremental Fock test
+BOOST_FIXTURE_TEST_CASE( Water_631Gd_incfock, SerialJob ) {
+
+  CQSCFALTTEST( scf/serial/rhf/water_6-31Gd_incfock, water_6-31Gd.bin.ref );
+ 
+};
+
+// Water 6-31G(d) TRS4 purification test
+BOOST_FIXTURE_TEST_CASE( Water_631Gd_trs4, SerialJob ) {
+
+  CQSCFALTTEST( scf/serial/rhf/water_6-31Gd_trs4, water_6-31Gd.bin.ref );
+ 
+};
+
+// Water 6-31G(d) canonical purification test
+BOOST_FIXTURE_TEST_CASE( Water_631Gd_canonical, SerialJob ) {
+
+  CQSCFALTTEST( scf/serial/rhf/water_6-31Gd_canonical, 
+    water_6-31Gd.bin.ref );
+ 
+};
+
+// Water 6-31G(d) divide-and-conquer eigensolver test
+BOOST_FIXTURE_TEST_CASE( Water_631Gd_dc, SerialJob ) {
+
+  CQSCFALTTEST( scf/serial/rhf/water_6-31Gd_dc, water_6-31Gd.bin.ref );
+ 
+};
+
+// Water 6-31G(d) MRRR eigensolver test
+BOOST_FIXTURE_TEST_CASE( Water_631Gd_mrrr, SerialJob ) {
+
+  CQSCFALTTEST( scf/serial/rhf/water_6-31Gd_mrrr, water_6-31Gd.bin.ref );
+ 
+};
+
+// Water 6-31G(d) partial diagonalization test
+BOOST_FIXTURE_TEST_CASE( Water_631Gd_neigvirt, SerialJob ) {
+
+  CQSCFALTTEST( scf/serial/rhf/water_6-31Gd_neigvirt, 
+    water_6-31Gd.bin.ref );
+ 
+};
+
+// Water 6-31G(d) second-order SCF test
+BOOST_FIXTURE_TEST_CASE( Water_631Gd_soscf, SerialJob ) {
+
+  CQSCFALTTEST( scf/serial/rhf/water_6-31Gd_soscf, water_6-31Gd.bin.ref );
+ 
+};
+
+// Water 6-31G(d) EDIIS test
+BOOST_FIXTURE_TEST_CASE( Water_631Gd_ediis, SerialJob ) {
+
+  CQSCFALTTEST( scf/serial/rhf/water_6-31Gd_ediis, water_6-31Gd.bin.ref );
+ 
+};
+
+// Water 6-31G(d) ADIIS test
+BOOST_FIXTURE_TEST_CASE( Water_631Gd_adiis, SerialJob ) {
+
+  CQSCFALTTEST( scf/serial/rhf/water_6-31Gd_adiis, water_6-31Gd.bin.ref );
+ 
+};
+
+// Water 6-31G(d) EDIIS + CDIIS test
+BOOST_FIXTURE_TEST_CASE( Water_631Gd_cediis, SerialJob ) {
+
+  CQSCFALTTEST( scf/serial/rhf/water_6-31Gd_cediis, water_6-31Gd.bin.ref );
+ 
+};
+
+// Water 6-31G(d) ADIIS + CDIIS test
+BOOST_FIXTURE_TEST_CASE( Water_631Gd_cadiis, SerialJob ) {
+
+  CQSCFALTTEST( scf/serial/rhf/water_6-31Gd_cadiis, water_6-31Gd.bin.ref );
+ 
+};
+
+// Water 6-31G(d) density fitting (cc-pVDZ-RI) test
+BOOST_FIXTURE_TEST_CASE( Water_631Gd_denfit, SerialJob ) {
+
+  CQSCFTEST( scf/serial/rhf/water_6-31Gd_denfit,
+    water_6-31Gd_denfit.bin.ref );
+
+};
+
+// Water 6-31G(d) density fitting (cc-pVDZ-RI) vs exact energy (sanity check)
+BOOST_FIXTURE_TEST_CASE( Water_631Gd_denfit_vs_exact, SerialJob ) {
+
+  CQSCFENERGYTEST( scf/serial/rhf/water_6-31Gd_denfit, water_6-31Gd.bin.ref,
+    1e-2 );
+
+};
+
 #ifdef _CQ_DO_PARTESTS
 
 // SMP Water 6-31G(d) test
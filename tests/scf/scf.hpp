@@ -99,4 +99,36 @@ using namespace ChronusQ;
 
 #endif
 
+
+// SCF test of an alternative algorithm (SCF solver, grid, etc) which
+// reproduces an existing reference. Nothing to generate
+#ifdef _CQ_GENERATE_TESTS
+  #define CQSCFALTTEST( in, ref )
+#else
+  #define CQSCFALTTEST( in, ref ) CQSCFTEST( in, ref )
+#endif
+
+
+// SCF test of an approximate algorithm (density fitting, grid pruning, 
+// etc) whose total energy is within TOL of an existing (exact) reference. 
+// Nothing to generate
+#ifdef _CQ_GENERATE_TESTS
+  #define CQSCFENERGYTEST( in, ref, TOL )
+#else
+  #define CQSCFENERGYTEST( in, ref, TOL ) \
+    RunChronusQ(TEST_ROOT #in ".inp","STDOUT", \
+      TEST_OUT #in ".bin",TEST_OUT #in ".scr");\
+    \
+    SafeFile refFile(SCF_TEST_REF #ref,true);\
+    SafeFile resFile(TEST_OUT #in ".bin",true);\
+    \
+    double xDummy, yDummy;\
+    \
+    /* Check Energy */ \
+    refFile.readData("SCF/TOTAL_ENERGY",&xDummy);\
+    resFile.readData("SCF/TOTAL_ENERGY",&yDummy);\
+    BOOST_CHECK_MESSAGE(std::abs(yDummy - xDummy) < TOL, "ENERGY TEST FAILED " << std::abs(yDummy - xDummy) );
+#endif
+
+
 #endif
@@ -41,6 +41,51 @@ BOOST_FIXTURE_TEST_CASE( O2_631Gd, SerialJob ) {
 
 };
 
+// O2 6-31G(d) TRS4 purification test
+BOOST_FIXTURE_TEST_CASE( O2_631Gd_trs4, SerialJob ) {
+
+  CQSCFALTTEST( scf/serial/uhf/oxygen_6-31Gd_trs4, oxygen_6-31Gd.bin.ref );
+
+};
+
+// O2 6-31G(d) partial diagonalization test
+BOOST_FIXTURE_TEST_CASE( O2_631Gd_neigvirt, SerialJob ) {
+
+  CQSCFALTTEST( scf/serial/uhf/oxygen_6-31Gd_neigvirt, 
+    oxygen_6-31Gd.bin.ref );
+
+};
+
+// O2 6-31G(d) second-order SCF test
+BOOST_FIXTURE_TEST_CASE( O2_631Gd_soscf, SerialJob ) {
+
+  CQSCFALTTEST( scf/serial/uhf/oxygen_6-31Gd_soscf, oxygen_6-31Gd.bin.ref );
+
+};
+
+// O2 6-31G(d) ADIIS + CDIIS test
+BOOST_FIXTURE_TEST_CASE( O2_631Gd_cadiis, SerialJob ) {
+
+  CQSCFALTTEST( scf/serial/uhf/oxygen_6-31Gd_cadiis, oxygen_6-31Gd.bin.ref );
+
+};
+
+// O2 6-31G(d) density fitting (cc-pVDZ-RI) test
+BOOST_FIXTURE_TEST_CASE( O2_631Gd_denfit, SerialJob ) {
+
+  CQSCFTEST( scf/serial/uhf/oxygen_6-31Gd_denfit,
+    oxygen_6-31Gd_denfit.bin.ref );
+
+};
+
+// O2 6-31G(d) density fitting (cc-pVDZ-RI) vs exact energy (sanity check)
+BOOST_FIXTURE_TEST_CASE( O2_631Gd_denfit_vs_exact, SerialJob ) {
+
+  CQSCFENERGYTEST( scf/serial/uhf/oxygen_6-31Gd_denfit, oxygen_6-31Gd.bin.ref,
+    1e-2 );
+
+};
+
 #ifdef _CQ_DO_PARTESTS
 
 // SMP Li 6-31G(d) test
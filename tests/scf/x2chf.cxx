@@ -42,6 +42,22 @@ BOOST_FIXTURE_TEST_CASE( Water_6311pGdp_cart, SerialJob ) {
  
 };
 
+// Water 6-311+G(d,p) (Spherical) divide-and-conquer eigensolver test
+BOOST_FIXTURE_TEST_CASE( Water_6311pGdp_sph_dc, SerialJob ) {
+
+  CQSCFALTTEST( scf/serial/x2c/water_6-311+Gdp_sph_dc, 
+    water_6-311+Gdp_sph_x2c.bin.ref );
+ 
+};
+
+// Water 6-311+G(d,p) (Spherical) second-order SCF test
+BOOST_FIXTURE_TEST_CASE( Water_6311pGdp_sph_soscf, SerialJob ) {
+
+  CQSCFALTTEST( scf/serial/x2c/water_6-311+Gdp_sph_soscf, 
+    water_6-311+Gdp_sph_x2c.bin.ref );
+ 
+};
+
 
 #ifdef _CQ_DO_PARTESTS
 